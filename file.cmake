@@ -4,4 +4,19 @@ set(SOURCE_FILE
         src/fsuipc_client.cpp
         src/fsuipc_client.h
         src/fsuipc_export.h
+        src/fsuipc_transport.h
+        src/fsuipc_batch_log.cpp
+        src/fsuipc_batch_log.h
+        src/fsuipc_telemetry.cpp
+        src/fsuipc_telemetry.h
+        src/fsuipc_derived.cpp
+        src/fsuipc_derived.h
+        src/fsuipc_shared.cpp
+        src/fsuipc_shared.h
+        src/fsuipc_network.cpp
+        src/fsuipc_network.h
+        src/fsuipc_stats.cpp
+        src/fsuipc_stats.h
+        src/fsuipc_trace.cpp
+        src/fsuipc_trace.h
 )
@@ -2,10 +2,20 @@
 
 #include "fsuipc_client.h"
 #include "fsuipc_export.h"
+#include "fsuipc_telemetry.h"
+#include "fsuipc_derived.h"
+#include "fsuipc_shared.h"
+#include "fsuipc_network.h"
+#include "fsuipc_trace.h"
+#include <cstring>
+#include <mutex>
 #include <string>
 #include <sstream>
+#include <vector>
 
 FSUIPC::FSUIPCClient client;
+// Guards client against the gateway connection threads
+std::mutex clientMutex;
 FSUIPC::SimConnectionStatus status = FSUIPC::SimConnectionStatus::NO_CONNECTION;
 FSUIPC::ApiVersion apiVersion = FSUIPC::ApiVersion::API_UNKNOWN;
 
@@ -21,6 +31,11 @@ FSUIPC::COM2StandbyVer2 com2StandbyVer2;
 
 FSUIPC::RadioSwitch radioSwitch;
 
+FSUIPC::TelemetryRecorder telemetry;
+FSUIPC::DerivedGraph derived;
+FSUIPC::SnapshotPublisher publisher;
+FSUIPC::NetworkGateway gateway(client, clientMutex);
+
 uint32_t com1ActiveLast = 0;
 uint32_t com1StandbyLast = 0;
 uint32_t com2ActiveLast = 0;
@@ -42,19 +57,33 @@ void readFrequencyVer2();
 
 void processFrequencyData();
 
+bool publishDefaultOffsets();
+
+void copyClientError(ReturnValue *);
+
+bool fitsInBatch(size_t);
+
 DLL_EXPORT [[maybe_unused]] ReturnValue *OpenFSUIPCClient() {
+    FSUIPC_TRACE_SCOPE("OpenFSUIPCClient");
+    std::lock_guard<std::mutex> lock(clientMutex);
     auto *returnValue = new ReturnValue();
+    if (status != FSUIPC::CONNECTED && !client.setTransport(nullptr)) {
+        copyClientError(returnValue);
+        return returnValue;
+    }
     if (client.open()) {
         returnValue->requestStatus = true;
         updateSimConnection(FSUIPC::CONNECTED);
         apiVersion = client.getApiVersion();
     } else {
-        returnValue->errMessage = client.getLastErrorMessage();
+        copyClientError(returnValue);
     }
     return returnValue;
 }
 
 DLL_EXPORT [[maybe_unused]] ReturnValue *ReadFrequencyInfo() {
+    FSUIPC_TRACE_SCOPE("ReadFrequencyInfo");
+    std::lock_guard<std::mutex> lock(clientMutex);
     auto *returnValue = new ReturnValue();
     if (status != FSUIPC::CONNECTED) {
         returnValue->requestStatus = false;
@@ -67,11 +96,34 @@ DLL_EXPORT [[maybe_unused]] ReturnValue *ReadFrequencyInfo() {
         return returnValue;
     }
     client.readBYTE(radioSwitch);
+    const char *queueError = nullptr;
+    if (!telemetry.queue(client)) {
+        queueError = telemetry.getLastErrorMessage();
+    } else if (!derived.queue(client)) {
+        queueError = derived.getLastErrorMessage();
+    } else if (!publisher.queue(client)) {
+        queueError = publisher.getLastErrorMessage();
+    }
+    if (queueError) {
+        client.discardRequests();
+        returnValue->errMessage = queueError;
+        return returnValue;
+    }
     if (apiVersion == FSUIPC::ApiVersion::API_VER1) {
         readFrequencyVer1();
     } else {
         readFrequencyVer2();
     }
+    bool processed = client.getLastError() == FSUIPC::Error::OK;
+    if (!processed) {
+        // Copied now, the disconnect() a failed read may trigger clears the client error
+        copyClientError(returnValue);
+    }
+    if (processed) {
+        telemetry.commit();
+        derived.commit();
+        publisher.commit();
+    }
     processFrequencyData();
 
     returnValue->frequency[0] = com1Active;
@@ -81,33 +133,437 @@ DLL_EXPORT [[maybe_unused]] ReturnValue *ReadFrequencyInfo() {
 
     returnValue->frequencyFlag = radioSwitch.data;
 
-    if (client.getLastError() == FSUIPC::Error::OK) {
-        returnValue->requestStatus = true;
-        return returnValue;
-    }
-    returnValue->errMessage = client.getLastErrorMessage();
+    returnValue->requestStatus = processed;
     return returnValue;
 }
 
 DLL_EXPORT [[maybe_unused]] ReturnValue *CloseFSUIPCClient() {
+    FSUIPC_TRACE_SCOPE("CloseFSUIPCClient");
+    std::lock_guard<std::mutex> lock(clientMutex);
     auto *returnValue = new ReturnValue();
     disconnect();
     if (client.getLastError() == FSUIPC::Error::OK) {
         returnValue->requestStatus = true;
         return returnValue;
     }
-    returnValue->errMessage = client.getLastErrorMessage();
+    copyClientError(returnValue);
     return returnValue;
 }
 
 DLL_EXPORT [[maybe_unused]] ReturnValue *GetConnectionState() {
+    FSUIPC_TRACE_SCOPE("GetConnectionState");
     auto *returnValue = new ReturnValue();
     returnValue->requestStatus = true;
     returnValue->status = status;
     return returnValue;
 }
 
+DLL_EXPORT [[maybe_unused]] ReturnValue *OpenFSUIPCReplay(const char *path, double speed) {
+    FSUIPC_TRACE_SCOPE("OpenFSUIPCReplay");
+    std::lock_guard<std::mutex> lock(clientMutex);
+    auto *returnValue = new ReturnValue();
+    if (status == FSUIPC::CONNECTED) {
+        returnValue->errMessage = "FSUIPC already connected";
+        return returnValue;
+    }
+    if (path == nullptr) {
+        returnValue->errMessage = "Replay log path is empty";
+        return returnValue;
+    }
+    if (!client.setTransport(std::make_unique<FSUIPC::ReplayTransport>(path, speed))) {
+        copyClientError(returnValue);
+        return returnValue;
+    }
+    if (client.open()) {
+        returnValue->requestStatus = true;
+        updateSimConnection(FSUIPC::CONNECTED);
+        apiVersion = client.getApiVersion();
+    } else {
+        copyClientError(returnValue);
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *StartBatchRecording(const char *path) {
+    FSUIPC_TRACE_SCOPE("StartBatchRecording");
+    std::lock_guard<std::mutex> lock(clientMutex);
+    auto *returnValue = new ReturnValue();
+    if (path == nullptr) {
+        returnValue->errMessage = "Batch log path is empty";
+        return returnValue;
+    }
+    auto recorder = std::make_unique<FSUIPC::BatchRecorder>();
+    // Started on an open connection, the log keeps the handshake in its header
+    FSUIPC::VersionInfo version{};
+    bool created;
+    if (status == FSUIPC::CONNECTED && client.getVersion(version)) {
+        created = recorder->open(path, &version, client.getApiVersion());
+    } else {
+        created = recorder->open(path);
+    }
+    if (!created) {
+        returnValue->errMessage = "Failed to create batch log file";
+        return returnValue;
+    }
+    client.setRecorder(std::move(recorder));
+    returnValue->requestStatus = true;
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *StopBatchRecording() {
+    FSUIPC_TRACE_SCOPE("StopBatchRecording");
+    std::lock_guard<std::mutex> lock(clientMutex);
+    auto *returnValue = new ReturnValue();
+    if (client.getRecorder() == nullptr) {
+        returnValue->errMessage = "Batch recording not started";
+        return returnValue;
+    }
+    client.setRecorder(nullptr);
+    returnValue->requestStatus = true;
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *OpenFSUIPCSubscriber(const char *name) {
+    FSUIPC_TRACE_SCOPE("OpenFSUIPCSubscriber");
+    std::lock_guard<std::mutex> lock(clientMutex);
+    auto *returnValue = new ReturnValue();
+    if (status == FSUIPC::CONNECTED) {
+        returnValue->errMessage = "FSUIPC already connected";
+        return returnValue;
+    }
+    if (name == nullptr) {
+        returnValue->errMessage = "Shared memory name is empty";
+        return returnValue;
+    }
+    if (!client.setTransport(std::make_unique<FSUIPC::SnapshotTransport>(name))) {
+        copyClientError(returnValue);
+        return returnValue;
+    }
+    if (client.open()) {
+        returnValue->requestStatus = true;
+        updateSimConnection(FSUIPC::CONNECTED);
+        apiVersion = client.getApiVersion();
+    } else {
+        copyClientError(returnValue);
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *StartPublisher(const char *name) {
+    FSUIPC_TRACE_SCOPE("StartPublisher");
+    auto *returnValue = new ReturnValue();
+    if (name == nullptr) {
+        returnValue->errMessage = "Shared memory name is empty";
+        return returnValue;
+    }
+    if (!publisher.create(name) || !publishDefaultOffsets()) {
+        returnValue->errMessage = publisher.getLastErrorMessage();
+        publisher.close();
+        return returnValue;
+    }
+    returnValue->requestStatus = true;
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *StopPublisher() {
+    FSUIPC_TRACE_SCOPE("StopPublisher");
+    auto *returnValue = new ReturnValue();
+    publisher.close();
+    returnValue->requestStatus = true;
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *AddPublishedOffset(uint32_t offset, uint32_t size) {
+    FSUIPC_TRACE_SCOPE("AddPublishedOffset");
+    auto *returnValue = new ReturnValue();
+    if (!publisher.hasOffset(offset, size) && !fitsInBatch(sizeof(FSUIPC::ReadHeader) + size)) {
+        returnValue->errMessage = "Published offset does not fit in the ReadFrequencyInfo batch";
+        return returnValue;
+    }
+    if (publisher.addOffset(offset, size)) {
+        returnValue->requestStatus = true;
+    } else {
+        returnValue->errMessage = publisher.getLastErrorMessage();
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *OpenFSUIPCRemote(const char *host, uint16_t port, bool compress,
+                                                          uint32_t pipelineDepth, uint32_t maxAgeMs) {
+    FSUIPC_TRACE_SCOPE("OpenFSUIPCRemote");
+    std::lock_guard<std::mutex> lock(clientMutex);
+    auto *returnValue = new ReturnValue();
+    if (status == FSUIPC::CONNECTED) {
+        returnValue->errMessage = "FSUIPC already connected";
+        return returnValue;
+    }
+    if (host == nullptr) {
+        returnValue->errMessage = "Gateway host is empty";
+        return returnValue;
+    }
+    auto transport = std::make_unique<FSUIPC::NetworkTransport>(host, port, compress, pipelineDepth, maxAgeMs);
+    if (!client.setTransport(std::move(transport))) {
+        copyClientError(returnValue);
+        return returnValue;
+    }
+    if (client.open()) {
+        returnValue->requestStatus = true;
+        updateSimConnection(FSUIPC::CONNECTED);
+        apiVersion = client.getApiVersion();
+    } else {
+        copyClientError(returnValue);
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *StartGateway(const char *address, uint16_t port) {
+    FSUIPC_TRACE_SCOPE("StartGateway");
+    auto *returnValue = new ReturnValue();
+    if (address == nullptr) {
+        returnValue->errMessage = "Gateway address is empty";
+        return returnValue;
+    }
+    if (gateway.start(address, port)) {
+        returnValue->requestStatus = true;
+    } else {
+        returnValue->errMessage = gateway.getLastErrorMessage();
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *StopGateway() {
+    FSUIPC_TRACE_SCOPE("StopGateway");
+    auto *returnValue = new ReturnValue();
+    gateway.stop();
+    returnValue->requestStatus = true;
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *AddTelemetryChannel(uint32_t offset, uint32_t size) {
+    FSUIPC_TRACE_SCOPE("AddTelemetryChannel");
+    auto *returnValue = new ReturnValue();
+    if (!fitsInBatch(sizeof(FSUIPC::ReadHeader) + size)) {
+        returnValue->errMessage = "Telemetry channel does not fit in the ReadFrequencyInfo batch";
+        return returnValue;
+    }
+    if (telemetry.addChannel(offset, size)) {
+        returnValue->requestStatus = true;
+    } else {
+        returnValue->errMessage = telemetry.getLastErrorMessage();
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *RemoveTelemetryChannel(uint32_t offset) {
+    FSUIPC_TRACE_SCOPE("RemoveTelemetryChannel");
+    auto *returnValue = new ReturnValue();
+    if (telemetry.removeChannel(offset)) {
+        returnValue->requestStatus = true;
+    } else {
+        returnValue->errMessage = telemetry.getLastErrorMessage();
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *SetTelemetryRetention(uint64_t maxBytes) {
+    FSUIPC_TRACE_SCOPE("SetTelemetryRetention");
+    auto *returnValue = new ReturnValue();
+    telemetry.setRetention(maxBytes);
+    returnValue->requestStatus = true;
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *StartTelemetryStream(const char *path) {
+    FSUIPC_TRACE_SCOPE("StartTelemetryStream");
+    auto *returnValue = new ReturnValue();
+    if (path == nullptr) {
+        returnValue->errMessage = "Telemetry stream path is empty";
+        return returnValue;
+    }
+    if (telemetry.openStream(path)) {
+        returnValue->requestStatus = true;
+    } else {
+        returnValue->errMessage = telemetry.getLastErrorMessage();
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *StopTelemetryStream() {
+    FSUIPC_TRACE_SCOPE("StopTelemetryStream");
+    auto *returnValue = new ReturnValue();
+    telemetry.closeStream();
+    returnValue->requestStatus = true;
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *ExportTelemetry(const char *path) {
+    FSUIPC_TRACE_SCOPE("ExportTelemetry");
+    auto *returnValue = new ReturnValue();
+    if (path == nullptr) {
+        returnValue->errMessage = "Telemetry export path is empty";
+        return returnValue;
+    }
+    if (telemetry.exportTo(path)) {
+        returnValue->requestStatus = true;
+    } else {
+        returnValue->errMessage = telemetry.getLastErrorMessage();
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] TelemetrySeries *QueryTelemetry(uint32_t offset, int64_t from, int64_t to) {
+    FSUIPC_TRACE_SCOPE("QueryTelemetry");
+    auto *series = new TelemetrySeries();
+    if (!telemetry.hasChannel(offset)) {
+        series->errMessage = "Telemetry channel not found";
+        return series;
+    }
+    auto samples = telemetry.query(offset, from, to);
+    series->count = static_cast<uint32_t>(samples.size());
+    series->timestamp = new int64_t[samples.size()];
+    series->value = new int64_t[samples.size()];
+    for (size_t i = 0; i < samples.size(); i++) {
+        series->timestamp[i] = samples[i].timestamp;
+        series->value[i] = samples[i].value;
+    }
+    series->requestStatus = true;
+    return series;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *AddDerivedValue(uint32_t kind, const FSUIPC::DerivedInput *inputs,
+                                                         uint32_t inputCount, double scale, double bias) {
+    FSUIPC_TRACE_SCOPE("AddDerivedValue");
+    auto *returnValue = new ReturnValue();
+    if (inputs == nullptr || inputCount == 0) {
+        returnValue->errMessage = "Derived value inputs are empty";
+        return returnValue;
+    }
+    std::vector<FSUIPC::DerivedInput> valueInputs(inputs, inputs + inputCount);
+    if (!fitsInBatch(derived.getAddedBatchSize(valueInputs))) {
+        returnValue->errMessage = "Derived value inputs do not fit in the ReadFrequencyInfo batch";
+        return returnValue;
+    }
+    if (derived.addValue(static_cast<FSUIPC::DerivedKind>(kind), valueInputs, scale, bias) >= 0) {
+        returnValue->requestStatus = true;
+    } else {
+        returnValue->errMessage = derived.getLastErrorMessage();
+    }
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *ClearDerivedValues() {
+    FSUIPC_TRACE_SCOPE("ClearDerivedValues");
+    auto *returnValue = new ReturnValue();
+    derived.clear();
+    returnValue->requestStatus = true;
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] DerivedValues *ReadDerivedValues() {
+    FSUIPC_TRACE_SCOPE("ReadDerivedValues");
+    auto *derivedValues = new DerivedValues();
+    size_t count = derived.size();
+    derivedValues->count = static_cast<uint32_t>(count);
+    derivedValues->value = new double[count];
+    derivedValues->version = new uint64_t[count];
+    for (size_t i = 0; i < count; i++) {
+        derivedValues->value[i] = derived.getValue(i);
+        derivedValues->version[i] = derived.getVersion(i);
+    }
+    derivedValues->requestStatus = true;
+    return derivedValues;
+}
+
+DLL_EXPORT [[maybe_unused]] StatisticsValue *GetStatistics() {
+    FSUIPC_TRACE_SCOPE("GetStatistics");
+    std::lock_guard<std::mutex> lock(clientMutex);
+    auto *statisticsValue = new StatisticsValue();
+    const FSUIPC::Statistics &statistics = client.getStatistics();
+    statisticsValue->buildTime = statistics.buildTime.summarize();
+    statisticsValue->roundTripTime = statistics.roundTripTime.summarize();
+    statisticsValue->parseTime = statistics.parseTime.summarize();
+    statisticsValue->batchBytes = statistics.batchBytes.summarize();
+    statisticsValue->batchRequests = statistics.batchRequests.summarize();
+    statisticsValue->batches = statistics.batches;
+    statisticsValue->failedBatches = statistics.failedBatches;
+    statisticsValue->retries = statistics.retries;
+    statisticsValue->timeouts = statistics.timeouts;
+    statisticsValue->sendErrors = statistics.sendErrors;
+    statisticsValue->badData = statistics.badData;
+    statisticsValue->bytes = statistics.bytes;
+    statisticsValue->requests = statistics.requests;
+    statisticsValue->reconnects = statistics.reconnects;
+    statisticsValue->requestStatus = true;
+    return statisticsValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *ResetStatistics() {
+    FSUIPC_TRACE_SCOPE("ResetStatistics");
+    std::lock_guard<std::mutex> lock(clientMutex);
+    auto *returnValue = new ReturnValue();
+    client.resetStatistics();
+    returnValue->requestStatus = true;
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *DumpTrace([[maybe_unused]] const char *path) {
+    FSUIPC_TRACE_SCOPE("DumpTrace");
+    auto *returnValue = new ReturnValue();
+#ifdef FSUIPC_TRACE
+    if (path == nullptr) {
+        returnValue->errMessage = "Trace path is empty";
+        return returnValue;
+    }
+    if (FSUIPC::Trace::dump(path)) {
+        returnValue->requestStatus = true;
+    } else {
+        returnValue->errMessage = "Failed to write trace file";
+    }
+#else
+    returnValue->errMessage = "Tracing is disabled in this build";
+#endif
+    return returnValue;
+}
+
+DLL_EXPORT [[maybe_unused]] ReturnValue *ClearTrace() {
+    FSUIPC_TRACE_SCOPE("ClearTrace");
+    auto *returnValue = new ReturnValue();
+#ifdef FSUIPC_TRACE
+    FSUIPC::Trace::clear();
+    returnValue->requestStatus = true;
+#else
+    returnValue->errMessage = "Tracing is disabled in this build";
+#endif
+    return returnValue;
+}
+
 DLL_EXPORT [[maybe_unused]] void FreeMemory(ReturnValue *pointer) {
+    FSUIPC_TRACE_SCOPE("FreeMemory");
+    delete pointer;
+}
+
+DLL_EXPORT [[maybe_unused]] void FreeTelemetrySeries(TelemetrySeries *pointer) {
+    FSUIPC_TRACE_SCOPE("FreeTelemetrySeries");
+    if (pointer == nullptr) {
+        return;
+    }
+    delete[] pointer->timestamp;
+    delete[] pointer->value;
+    delete pointer;
+}
+
+DLL_EXPORT [[maybe_unused]] void FreeDerivedValues(DerivedValues *pointer) {
+    FSUIPC_TRACE_SCOPE("FreeDerivedValues");
+    if (pointer == nullptr) {
+        return;
+    }
+    delete[] pointer->value;
+    delete[] pointer->version;
+    delete pointer;
+}
+
+DLL_EXPORT [[maybe_unused]] void FreeStatistics(StatisticsValue *pointer) {
+    FSUIPC_TRACE_SCOPE("FreeStatistics");
     delete pointer;
 }
 
@@ -118,7 +574,7 @@ uint32_t processNumber(int n) {
 
     uint32_t converted = stol(hexStr);
 
-    return (uint32_t) (converted * 10 + 100000 + (converted % 5) * 2.5) * 1000;
+    return FSUIPC::bcdFrequency(converted);
 }
 
 void updateSimConnection(FSUIPC::SimConnectionStatus connectionStatus) {
@@ -127,6 +583,7 @@ void updateSimConnection(FSUIPC::SimConnectionStatus connectionStatus) {
 
 void disconnect() {
     if (status == FSUIPC::CONNECTED) {
+        publisher.markDisconnected();
         client.close();
         apiVersion = FSUIPC::ApiVersion::API_UNKNOWN;
         updateSimConnection(FSUIPC::NO_CONNECTION);
@@ -168,3 +625,31 @@ void processFrequencyData() {
     if (com2Active != com2ActiveLast) { com2ActiveLast = com2Active; }
     if (com2Standby != com2StandbyLast) { com2StandbyLast = com2Standby; }
 }
+
+bool publishDefaultOffsets() {
+    // Everything OpenFSUIPCClient and ReadFrequencyInfo read, so subscribers run them unchanged
+    return publisher.addOffset(0x3304, sizeof(DWORD)) &&
+           publisher.addOffset(0x3308, sizeof(DWORD)) &&
+           publisher.addOffset(radioSwitch.offset, radioSwitch.size) &&
+           publisher.addOffset(com1ActiveVer1.offset, com1ActiveVer1.size) &&
+           publisher.addOffset(com2ActiveVer1.offset, com2ActiveVer1.size) &&
+           publisher.addOffset(com1StandbyVer1.offset, com1StandbyVer1.size) &&
+           publisher.addOffset(com2StandbyVer1.offset, com2StandbyVer1.size) &&
+           publisher.addOffset(com1ActiveVer2.offset, com1ActiveVer2.size) &&
+           publisher.addOffset(com2ActiveVer2.offset, com2ActiveVer2.size) &&
+           publisher.addOffset(com1StandbyVer2.offset, com1StandbyVer2.size) &&
+           publisher.addOffset(com2StandbyVer2.offset, com2StandbyVer2.size);
+}
+
+void copyClientError(ReturnValue *returnValue) {
+    // Gateway threads may change the client error as soon as clientMutex is released
+    strncpy(returnValue->errBuffer, client.getLastErrorMessage(), sizeof(returnValue->errBuffer) - 1);
+    returnValue->errMessage = returnValue->errBuffer;
+}
+
+bool fitsInBatch(size_t size) {
+    // The radio switch and the four frequencies, read with the larger ver2 offsets
+    size_t used = sizeof(FSUIPC::ReadHeader) * 5 + radioSwitch.size + com1ActiveVer2.size * 4;
+    used += telemetry.getBatchSize() + derived.getBatchSize() + publisher.getBatchSize();
+    return used + size + sizeof(DWORD) <= FSUIPC::FSUIPCClient::MAX_SIZE;
+}
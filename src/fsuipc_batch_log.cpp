@@ -0,0 +1,386 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#include "fsuipc_batch_log.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace FSUIPC {
+    constexpr uint32_t SIMULATOR_VERSION_MARKER = 0xFADE0000;
+
+    static size_t alignRecord(size_t size) {
+        return (size + 7) & ~static_cast<size_t>(7);
+    }
+
+    BatchRecorder::~BatchRecorder() {
+        close();
+    }
+
+    bool BatchRecorder::open(const std::string &path, const VersionInfo *handshake, ApiVersion apiVersion) {
+        close();
+
+        hFile = CreateFile(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            lastErrorMessage = "Failed to create batch log file";
+            return false;
+        }
+
+        BatchLogHeader header{};
+        memcpy(header.magic, BATCH_LOG_MAGIC, sizeof(header.magic));
+        header.version = BATCH_LOG_VERSION;
+        header.headerSize = sizeof(BatchLogHeader);
+        header.createdAt = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        if (handshake) {
+            header.flags = BATCH_LOG_HANDSHAKE;
+            header.fsuipcVersion = handshake->fsuipc;
+            // FSUIPCClient strips the marker once the version is verified
+            header.simulatorVersion = SIMULATOR_VERSION_MARKER | (handshake->simulator & 0xFFFF);
+            header.apiVersion = apiVersion;
+        }
+
+        DWORD written = 0;
+        if (!WriteFile(hFile, &header, sizeof(header), &written, nullptr) || written != sizeof(header)) {
+            lastErrorMessage = "Failed to write batch log header";
+            close();
+            return false;
+        }
+
+        origin = std::chrono::steady_clock::now();
+        sequence = 0;
+        lastErrorMessage.clear();
+        return true;
+    }
+
+    void BatchRecorder::close() noexcept {
+        if (hFile != INVALID_HANDLE_VALUE) {
+            FlushFileBuffers(hFile);
+            CloseHandle(hFile);
+            hFile = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    bool BatchRecorder::isOpen() const noexcept {
+        return hFile != INVALID_HANDLE_VALUE;
+    }
+
+    void BatchRecorder::beginBatch(const BYTE *request, size_t size) {
+        if (!isOpen()) {
+            return;
+        }
+
+        size_t recordSize = alignRecord(sizeof(BatchLogRecord) + size * 2);
+        scratch.assign(recordSize, 0);
+
+        auto *record = reinterpret_cast<BatchLogRecord *>(scratch.data());
+        record->magic = BATCH_RECORD_MAGIC;
+        record->recordSize = static_cast<uint32_t>(recordSize);
+        record->sequence = sequence;
+        record->imageSize = static_cast<uint32_t>(size);
+        record->sendTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - origin).count();
+
+        memcpy(scratch.data() + sizeof(BatchLogRecord), request, size);
+    }
+
+    void BatchRecorder::endBatch(const BYTE *response, size_t size, Error status) {
+        if (!isOpen() || scratch.empty()) {
+            return;
+        }
+
+        auto *record = reinterpret_cast<BatchLogRecord *>(scratch.data());
+        if (record->imageSize != size) {
+            lastErrorMessage = "Batch response size does not match request size";
+            scratch.clear();
+            return;
+        }
+
+        record->receiveTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - origin).count();
+        record->status = static_cast<uint32_t>(status);
+        memcpy(scratch.data() + sizeof(BatchLogRecord) + size, response, size);
+
+        DWORD written = 0;
+        if (!WriteFile(hFile, scratch.data(), static_cast<DWORD>(scratch.size()), &written, nullptr) ||
+            written != scratch.size()) {
+            lastErrorMessage = "Failed to append batch record";
+        } else {
+            sequence++;
+        }
+        scratch.clear();
+    }
+
+    uint64_t BatchRecorder::getRecordCount() const noexcept {
+        return sequence;
+    }
+
+    const char *BatchRecorder::getLastErrorMessage() const noexcept {
+        return lastErrorMessage.c_str();
+    }
+
+    BatchLogReader::~BatchLogReader() {
+        close();
+    }
+
+    bool BatchLogReader::open(const std::string &path) {
+        close();
+
+        hFile = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            lastErrorMessage = "Failed to open batch log file";
+            return false;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(hFile, &fileSize) ||
+            fileSize.QuadPart < static_cast<LONGLONG>(sizeof(BatchLogHeader))) {
+            lastErrorMessage = "Batch log file is too small";
+            close();
+            return false;
+        }
+
+        hMap = CreateFileMapping(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!hMap) {
+            lastErrorMessage = "Failed to map batch log file";
+            close();
+            return false;
+        }
+
+        pView = static_cast<const BYTE *>(MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
+        if (!pView) {
+            lastErrorMessage = "Failed to map view of batch log file";
+            close();
+            return false;
+        }
+        viewSize = static_cast<size_t>(fileSize.QuadPart);
+
+        auto *header = reinterpret_cast<const BatchLogHeader *>(pView);
+        if (memcmp(header->magic, BATCH_LOG_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != BATCH_LOG_VERSION ||
+            header->headerSize < sizeof(BatchLogHeader) ||
+            header->headerSize > viewSize) {
+            lastErrorMessage = "Not a batch log file";
+            close();
+            return false;
+        }
+
+        rewind();
+        lastErrorMessage.clear();
+        return true;
+    }
+
+    void BatchLogReader::close() noexcept {
+        if (pView) {
+            UnmapViewOfFile(pView);
+            pView = nullptr;
+        }
+
+        if (hMap) {
+            CloseHandle(hMap);
+            hMap = nullptr;
+        }
+
+        if (hFile != INVALID_HANDLE_VALUE) {
+            CloseHandle(hFile);
+            hFile = INVALID_HANDLE_VALUE;
+        }
+
+        viewSize = 0;
+        position = 0;
+    }
+
+    const BatchLogRecord *BatchLogReader::next() {
+        if (!pView || position + sizeof(BatchLogRecord) > viewSize) {
+            return nullptr;
+        }
+
+        auto *record = reinterpret_cast<const BatchLogRecord *>(pView + position);
+        if (record->magic != BATCH_RECORD_MAGIC ||
+            record->recordSize < sizeof(BatchLogRecord) + static_cast<size_t>(record->imageSize) * 2 ||
+            position + record->recordSize > viewSize) {
+            return nullptr;
+        }
+
+        position += record->recordSize;
+        return record;
+    }
+
+    void BatchLogReader::rewind() noexcept {
+        position = pView ? reinterpret_cast<const BatchLogHeader *>(pView)->headerSize : 0;
+    }
+
+    const BatchLogHeader *BatchLogReader::getHandshake() const noexcept {
+        if (!pView) {
+            return nullptr;
+        }
+        auto *header = reinterpret_cast<const BatchLogHeader *>(pView);
+        return header->flags & BATCH_LOG_HANDSHAKE ? header : nullptr;
+    }
+
+    const BYTE *BatchLogReader::requestImage(const BatchLogRecord *record) noexcept {
+        return reinterpret_cast<const BYTE *>(record) + sizeof(BatchLogRecord);
+    }
+
+    const BYTE *BatchLogReader::responseImage(const BatchLogRecord *record) noexcept {
+        return requestImage(record) + record->imageSize;
+    }
+
+    const char *BatchLogReader::getLastErrorMessage() const noexcept {
+        return lastErrorMessage.c_str();
+    }
+
+    ReplayTransport::ReplayTransport(std::string path, double speed) : path(std::move(path)), speed(speed) {}
+
+    bool ReplayTransport::connect() {
+        if (!reader.open(path)) {
+            setLastError(Error::LOG_FILE, reader.getLastErrorMessage());
+            return false;
+        }
+        firstSendTime = -1;
+        handshake = reader.getHandshake();
+        clearError();
+        return true;
+    }
+
+    void ReplayTransport::disconnect() noexcept {
+        reader.close();
+        handshake = nullptr;
+    }
+
+    bool ReplayTransport::transact(BYTE *buffer, size_t size) {
+        if (handshake) {
+            return answerHandshake(buffer, size);
+        }
+
+        const BatchLogRecord *record = reader.next();
+        if (!record) {
+            setLastError(Error::REPLAY_END, "No more batches in replay log");
+            return false;
+        }
+
+        if (record->imageSize != size) {
+            setLastError(Error::REPLAY_MISMATCH, "Batch size differs from the recorded batch");
+            return false;
+        }
+
+        waitForSchedule(record);
+
+        const BYTE *request = BatchLogReader::requestImage(record);
+        const BYTE *response = BatchLogReader::responseImage(record);
+        size_t position = 0;
+
+        while (position + sizeof(DWORD) <= size) {
+            DWORD id;
+            memcpy(&id, buffer + position, sizeof(DWORD));
+            if (id == 0) {
+                break;
+            }
+
+            if (id == static_cast<DWORD>(MessageType::READ) && position + sizeof(ReadHeader) <= size) {
+                ReadHeader current{}, recorded{};
+                memcpy(&current, buffer + position, sizeof(ReadHeader));
+                memcpy(&recorded, request + position, sizeof(ReadHeader));
+                if (recorded.id != current.id || recorded.offset != current.offset ||
+                    recorded.size != current.size || position + sizeof(ReadHeader) + current.size > size) {
+                    setLastError(Error::REPLAY_MISMATCH, "Read request differs from the recorded batch");
+                    return false;
+                }
+                position += sizeof(ReadHeader);
+                memcpy(buffer + position, response + position, current.size);
+                position += current.size;
+            } else if (id == static_cast<DWORD>(MessageType::WRITE) && position + sizeof(WriteHeader) <= size) {
+                WriteHeader current{}, recorded{};
+                memcpy(&current, buffer + position, sizeof(WriteHeader));
+                memcpy(&recorded, request + position, sizeof(WriteHeader));
+                if (recorded.id != current.id || recorded.offset != current.offset ||
+                    recorded.size != current.size || position + sizeof(WriteHeader) + current.size > size) {
+                    setLastError(Error::REPLAY_MISMATCH, "Write request differs from the recorded batch");
+                    return false;
+                }
+                position += sizeof(WriteHeader) + current.size;
+            } else {
+                setLastError(Error::REPLAY_MISMATCH, "Malformed request image");
+                return false;
+            }
+        }
+
+        auto status = static_cast<Error>(record->status);
+        if (status != Error::OK) {
+            setLastError(status, "Recorded batch failed");
+            return false;
+        }
+
+        clearError();
+        return true;
+    }
+
+    bool ReplayTransport::answerHandshake(BYTE *buffer, size_t size) {
+        const uint32_t probeVer1 = COM1ActiveVer1().offset;
+        const uint32_t probeVer2 = COM1ActiveVer2().offset;
+        bool probed = false;
+        size_t position = 0;
+
+        while (position + sizeof(DWORD) <= size) {
+            DWORD id;
+            memcpy(&id, buffer + position, sizeof(DWORD));
+            if (id == 0) {
+                break;
+            }
+
+            if (id == static_cast<DWORD>(MessageType::READ) && position + sizeof(ReadHeader) <= size) {
+                ReadHeader header{};
+                memcpy(&header, buffer + position, sizeof(ReadHeader));
+                position += sizeof(ReadHeader);
+                if (position + header.size > size) {
+                    setLastError(Error::REPLAY_MISMATCH, "Malformed request image");
+                    return false;
+                }
+
+                uint32_t value = 0;
+                if (header.offset == 0x3304) {
+                    value = handshake->fsuipcVersion;
+                } else if (header.offset == 0x3308) {
+                    value = handshake->simulatorVersion;
+                } else if (header.offset == probeVer1) {
+                    value = handshake->apiVersion == API_VER1 ? 1 : 0;
+                } else if (header.offset == probeVer2) {
+                    value = handshake->apiVersion == API_VER2 ? 1 : 0;
+                    probed = true;
+                }
+                memset(buffer + position, 0, header.size);
+                memcpy(buffer + position, &value, std::min<size_t>(header.size, sizeof(value)));
+                position += header.size;
+            } else if (id == static_cast<DWORD>(MessageType::WRITE) && position + sizeof(WriteHeader) <= size) {
+                WriteHeader header{};
+                memcpy(&header, buffer + position, sizeof(WriteHeader));
+                position += sizeof(WriteHeader) + header.size;
+            } else {
+                setLastError(Error::REPLAY_MISMATCH, "Malformed request image");
+                return false;
+            }
+        }
+
+        // The API version probe is the last batch of open(); recorded batches follow
+        if (probed) {
+            handshake = nullptr;
+        }
+        clearError();
+        return true;
+    }
+
+    void ReplayTransport::waitForSchedule(const BatchLogRecord *record) {
+        if (firstSendTime < 0) {
+            firstSendTime = record->sendTime;
+            replayStart = std::chrono::steady_clock::now();
+        }
+
+        if (speed <= 0.0) {
+            return;
+        }
+
+        auto elapsed = static_cast<double>(record->receiveTime - firstSendTime) / speed;
+        std::this_thread::sleep_until(replayStart + std::chrono::nanoseconds(static_cast<int64_t>(elapsed)));
+    }
+}
@@ -0,0 +1,139 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "fsuipc_transport.h"
+
+namespace FSUIPC {
+    // On-disk layout of a batch log:
+    //   BatchLogHeader, then BatchLogRecord* until end of file.
+    // Each record is followed by the request image and the response image
+    // (both imageSize bytes) and padded to 8 bytes, so the whole file can be
+    // mapped and walked in place. A truncated tail record is ignored.
+    // A log started on an open connection has no handshake batches; it sets
+    // BATCH_LOG_HANDSHAKE and keeps the handshake results in the header.
+    constexpr char BATCH_LOG_MAGIC[8] = {'F', 'S', 'U', 'I', 'P', 'C', 'B', 'L'};
+    constexpr uint32_t BATCH_LOG_VERSION = 1;
+    constexpr uint32_t BATCH_RECORD_MAGIC = 0x43455242;
+    constexpr uint32_t BATCH_LOG_HANDSHAKE = 0x1;
+
+    struct BatchLogHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        int64_t createdAt;
+        uint64_t reserved;
+        uint32_t flags;
+        uint32_t fsuipcVersion;
+        uint32_t simulatorVersion;
+        uint32_t apiVersion;
+    };
+
+    struct BatchLogRecord {
+        uint32_t magic;
+        uint32_t recordSize;
+        uint64_t sequence;
+        int64_t sendTime;
+        int64_t receiveTime;
+        uint32_t imageSize;
+        uint32_t status;
+    };
+
+    class BatchRecorder {
+    public:
+        BatchRecorder() = default;
+
+        ~BatchRecorder();
+
+        BatchRecorder(const BatchRecorder &) = delete;
+
+        BatchRecorder &operator=(const BatchRecorder &) = delete;
+
+        bool open(const std::string &path, const VersionInfo *handshake = nullptr,
+                  ApiVersion apiVersion = API_UNKNOWN);
+
+        void close() noexcept;
+
+        bool isOpen() const noexcept;
+
+        void beginBatch(const BYTE *request, size_t size);
+
+        void endBatch(const BYTE *response, size_t size, Error status);
+
+        uint64_t getRecordCount() const noexcept;
+
+        const char *getLastErrorMessage() const noexcept;
+
+    private:
+        HANDLE hFile = INVALID_HANDLE_VALUE;
+        std::vector<BYTE> scratch;
+        std::chrono::steady_clock::time_point origin;
+        uint64_t sequence = 0;
+        std::string lastErrorMessage;
+    };
+
+    class BatchLogReader {
+    public:
+        BatchLogReader() = default;
+
+        ~BatchLogReader();
+
+        BatchLogReader(const BatchLogReader &) = delete;
+
+        BatchLogReader &operator=(const BatchLogReader &) = delete;
+
+        bool open(const std::string &path);
+
+        void close() noexcept;
+
+        const BatchLogRecord *next();
+
+        void rewind() noexcept;
+
+        const BatchLogHeader *getHandshake() const noexcept;
+
+        static const BYTE *requestImage(const BatchLogRecord *record) noexcept;
+
+        static const BYTE *responseImage(const BatchLogRecord *record) noexcept;
+
+        const char *getLastErrorMessage() const noexcept;
+
+    private:
+        HANDLE hFile = INVALID_HANDLE_VALUE;
+        HANDLE hMap = nullptr;
+        const BYTE *pView = nullptr;
+        size_t viewSize = 0;
+        size_t position = 0;
+        std::string lastErrorMessage;
+    };
+
+    // Feeds recorded responses back to FSUIPCClient in order.
+    // speed == 0 replays as fast as possible, 1.0 keeps the original pacing
+    // and larger values accelerate it. When the log carries its handshake in
+    // the header, the handshake batches of open() are answered from there.
+    class ReplayTransport : public Transport {
+    public:
+        explicit ReplayTransport(std::string path, double speed = 0.0);
+
+        bool connect() override;
+
+        void disconnect() noexcept override;
+
+        bool transact(BYTE *buffer, size_t size) override;
+
+    private:
+        std::string path;
+        double speed;
+        BatchLogReader reader;
+        int64_t firstSendTime = -1;
+        std::chrono::steady_clock::time_point replayStart;
+        const BatchLogHeader *handshake = nullptr;
+
+        void waitForSchedule(const BatchLogRecord *record);
+
+        bool answerHandshake(BYTE *buffer, size_t size);
+    };
+}
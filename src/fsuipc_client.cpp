@@ -1,6 +1,7 @@
 // Copyright (c) 2025 Half_nothing MIT License
 
 #include "fsuipc_client.h"
+#include "fsuipc_trace.h"
 #include <cstring>
 #include <stdexcept>
 #include <sstream>
@@ -17,7 +18,11 @@ namespace FSUIPC {
         }
 
         if (pView) {
-            UnmapViewOfFile(pView);
+            if (buffer) {
+                buffer.reset();
+            } else {
+                UnmapViewOfFile(pView);
+            }
             pView = nullptr;
         }
 
@@ -52,18 +57,28 @@ namespace FSUIPC {
         try {
             if (initializeConnection(requested) && verifyVersion(requested)) {
                 checkApiVersion();
+                if (statistics.connections++ > 0) {
+                    statistics.reconnects++;
+                }
                 clearError();
                 return true;
             }
-            return false;
         } catch (...) {
-            state->reset();
-            return false;
         }
+
+        // A half-open connection would make isOpen() true and pin the transport
+        if (transport) {
+            transport->disconnect();
+        }
+        state->reset();
+        return false;
     }
 
     bool FSUIPCClient::close() noexcept {
         if (isOpen()) {
+            if (transport) {
+                transport->disconnect();
+            }
             state->reset();
             clearError();
             return true;
@@ -98,6 +113,12 @@ namespace FSUIPC {
             return false;
         }
 
+        if (state->pNext == state->pView) {
+            batchStart = std::chrono::steady_clock::now();
+            pendingRequests = 0;
+        }
+        pendingRequests++;
+
         auto *header = reinterpret_cast<ReadHeader *>(state->pNext);
         header->id = static_cast<DWORD>(MessageType::READ);
         header->offset = offset;
@@ -138,6 +159,12 @@ namespace FSUIPC {
             return false;
         }
 
+        if (state->pNext == state->pView) {
+            batchStart = std::chrono::steady_clock::now();
+            pendingRequests = 0;
+        }
+        pendingRequests++;
+
         auto *header = reinterpret_cast<WriteHeader *>(state->pNext);
         header->id = static_cast<DWORD>(MessageType::WRITE);
         header->offset = offset;
@@ -164,16 +191,155 @@ namespace FSUIPC {
             return false;
         }
 
+        FSUIPC_TRACE_SCOPE("process");
+        FSUIPC_TRACE_SINCE("serialize", batchStart);
+        statistics.buildTime.record(Statistics::elapsed(batchStart));
         ZeroMemory(state->pNext, 4);
+        size_t batchSize = state->pNext - state->pView + 4;
         state->pNext = state->pView;
 
-        sendRequests();
+        statistics.batches++;
+        statistics.bytes += batchSize;
+        statistics.requests += pendingRequests;
+        statistics.batchBytes.record(batchSize);
+        statistics.batchRequests.record(pendingRequests);
+
+        if (recorder) {
+            recorder->beginBatch(state->pView, batchSize);
+        }
+        auto sendStart = std::chrono::steady_clock::now();
+        bool sent = sendRequests(batchSize);
+        statistics.roundTripTime.record(Statistics::elapsed(sendStart));
+        if (recorder) {
+            recorder->endBatch(state->pView, batchSize, lastError);
+        }
+        if (!sent) {
+            statistics.recordFailure(lastError);
+            // Callers take all-zero reads as a lost simulator, so a failed batch still delivers zeros
+            zeroResponses(batchSize);
+            processResponses();
+            return false;
+        }
+
+        auto parseStart = std::chrono::steady_clock::now();
+        FSUIPC_TRACE_SCOPE("processResponses");
         processResponses();
+        statistics.parseTime.record(Statistics::elapsed(parseStart));
+        clearError();
+        return true;
+    }
+
+    bool FSUIPCClient::processImage(BYTE *image, size_t size) {
+        if (!isOpen()) {
+            setLastError(Error::NOT_OPEN, "Connection not open");
+            return false;
+        }
+
+        if (state->pNext != state->pView) {
+            setLastError(Error::BUFFER_FULL, "A local batch is still being built");
+            return false;
+        }
+
+        FSUIPC_TRACE_SCOPE("processImage");
+        auto buildStart = std::chrono::steady_clock::now();
+        size_t requestCount = 0;
+        size_t position = 0;
+        bool wellFormed = size <= MAX_SIZE;
+        // Sizes from the image are compared against what is left, never added to position
+        // first, so a huge size cannot wrap size_t on 32 bit builds
+        while (wellFormed) {
+            size_t remaining = size - position;
+            if (remaining < sizeof(DWORD)) {
+                wellFormed = false;
+                break;
+            }
+            auto *pdw = reinterpret_cast<const DWORD *>(image + position);
+            if (*pdw == 0) {
+                break;
+            }
+            if (*pdw == static_cast<DWORD>(MessageType::READ) && remaining >= sizeof(ReadHeader) &&
+                reinterpret_cast<const ReadHeader *>(pdw)->size <= remaining - sizeof(ReadHeader)) {
+                position += sizeof(ReadHeader) + reinterpret_cast<const ReadHeader *>(pdw)->size;
+            } else if (*pdw == static_cast<DWORD>(MessageType::WRITE) && remaining >= sizeof(WriteHeader) &&
+                       reinterpret_cast<const WriteHeader *>(pdw)->size <= remaining - sizeof(WriteHeader)) {
+                position += sizeof(WriteHeader) + reinterpret_cast<const WriteHeader *>(pdw)->size;
+            } else {
+                wellFormed = false;
+            }
+            requestCount++;
+        }
+        if (!wellFormed) {
+            setLastError(Error::BAD_DATA, "Malformed request image");
+            return false;
+        }
+
+        memcpy(state->pView, image, size);
+        statistics.buildTime.record(Statistics::elapsed(buildStart));
+
+        statistics.batches++;
+        statistics.bytes += size;
+        statistics.requests += requestCount;
+        statistics.batchBytes.record(size);
+        statistics.batchRequests.record(requestCount);
+
+        if (recorder) {
+            recorder->beginBatch(state->pView, size);
+        }
+        auto sendStart = std::chrono::steady_clock::now();
+        bool sent = sendRequests(size);
+        statistics.roundTripTime.record(Statistics::elapsed(sendStart));
+        if (recorder) {
+            recorder->endBatch(state->pView, size, lastError);
+        }
+        if (!sent) {
+            statistics.recordFailure(lastError);
+            return false;
+        }
+
+        auto parseStart = std::chrono::steady_clock::now();
+        memcpy(image, state->pView, size);
+        statistics.parseTime.record(Statistics::elapsed(parseStart));
+        clearError();
+        return true;
+    }
+
+    void FSUIPCClient::discardRequests() noexcept {
+        if (isOpen()) {
+            state->pNext = state->pView;
+        }
+    }
+
+    bool FSUIPCClient::setTransport(std::unique_ptr<Transport> newTransport) {
+        if (isOpen()) {
+            setLastError(Error::ALREADY_OPEN, "Can't change transport while the connection is open");
+            return false;
+        }
+        transport = std::move(newTransport);
         clearError();
         return true;
     }
 
+    void FSUIPCClient::setRecorder(std::unique_ptr<BatchRecorder> batchRecorder) {
+        recorder = std::move(batchRecorder);
+    }
+
+    BatchRecorder *FSUIPCClient::getRecorder() const noexcept {
+        return recorder.get();
+    }
+
+    const Statistics &FSUIPCClient::getStatistics() const noexcept {
+        return statistics;
+    }
+
+    void FSUIPCClient::resetStatistics() noexcept {
+        statistics.reset();
+    }
+
     bool FSUIPCClient::initializeConnection(Simulator requested) {
+        if (transport) {
+            return initializeTransport();
+        }
+
         static int nTry = 0;
         nTry++;
 
@@ -229,6 +395,19 @@ namespace FSUIPC {
         return true;
     }
 
+    bool FSUIPCClient::initializeTransport() {
+        if (!transport->connect()) {
+            setLastError(transport->getLastError(), transport->getLastErrorMessage());
+            return false;
+        }
+
+        state->buffer = std::make_unique<BYTE[]>(MAX_SIZE + 256);
+        state->pView = state->buffer.get();
+        state->pNext = state->pView;
+        clearError();
+        return true;
+    }
+
     bool FSUIPCClient::verifyVersion(Simulator requested) {
         int attempts = 0;
         const int maxAttempts = 5;
@@ -250,6 +429,9 @@ namespace FSUIPC {
         }
 
         if (attempts >= maxAttempts) {
+            if (lastError == Error::OK) {
+                setLastError(Error::VERSION_MISMATCH, "Failed to read a valid FSUIPC version");
+            }
             return false;
         }
 
@@ -269,23 +451,43 @@ namespace FSUIPC {
         return true;
     }
 
-    bool FSUIPCClient::sendRequests() {
+    bool FSUIPCClient::sendRequests(size_t size) {
+        FSUIPC_TRACE_SCOPE("sendRequests");
+        if (transport) {
+            FSUIPC_TRACE_SCOPE("transact");
+            if (!transport->transact(state->pView, size)) {
+                setLastError(transport->getLastError(), transport->getLastErrorMessage());
+                return false;
+            }
+            clearError();
+            return true;
+        }
+
         uint64_t dwError = 0;
         int attempts = 0;
         const int maxAttempts = 10;
 
         while (attempts++ < maxAttempts) {
-            if (SendMessageTimeout(
-                    state->hWnd,
-                    state->msg,
-                    state->atom,
-                    0,
-                    SMTO_BLOCK,
-                    2000,
-                    &dwError)) {
+            LRESULT sent;
+            {
+                FSUIPC_TRACE_SCOPE("SendMessageTimeout");
+                sent = SendMessageTimeout(
+                        state->hWnd,
+                        state->msg,
+                        state->atom,
+                        0,
+                        SMTO_BLOCK,
+                        2000,
+                        &dwError);
+            }
+            if (sent) {
                 break;
             }
-            Sleep(100);
+            if (attempts < maxAttempts) {
+                statistics.retries++;
+                FSUIPC_TRACE_SCOPE("retry");
+                Sleep(100);
+            }
         }
 
         if (attempts >= maxAttempts) {
@@ -348,9 +550,33 @@ namespace FSUIPC {
         return true;
     }
 
+    void FSUIPCClient::zeroResponses(size_t size) noexcept {
+        size_t position = 0;
+        while (size - position >= sizeof(DWORD)) {
+            size_t remaining = size - position;
+            auto *pdw = reinterpret_cast<DWORD *>(state->pView + position);
+            if (*pdw == 0) {
+                return;
+            }
+            if (*pdw == static_cast<DWORD>(MessageType::READ) && remaining >= sizeof(ReadHeader) &&
+                reinterpret_cast<ReadHeader *>(pdw)->size <= remaining - sizeof(ReadHeader)) {
+                auto *header = reinterpret_cast<ReadHeader *>(pdw);
+                ZeroMemory(state->pView + position + sizeof(ReadHeader), header->size);
+                position += sizeof(ReadHeader) + header->size;
+            } else if (*pdw == static_cast<DWORD>(MessageType::WRITE) && remaining >= sizeof(WriteHeader) &&
+                       reinterpret_cast<WriteHeader *>(pdw)->size <= remaining - sizeof(WriteHeader)) {
+                position += sizeof(WriteHeader) + reinterpret_cast<WriteHeader *>(pdw)->size;
+            } else {
+                // End the image here so processResponses() never walks past it
+                *pdw = 0;
+                return;
+            }
+        }
+    }
+
     void FSUIPCClient::clearError() {
         lastError = Error::OK;
-        lastErrorMessage = "";
+        lastErrorMessage.clear();
     }
 
     Error FSUIPCClient::getLastError() {
@@ -358,7 +584,7 @@ namespace FSUIPC {
     }
 
     const char * FSUIPCClient::getLastErrorMessage() {
-        return lastErrorMessage;
+        return lastErrorMessage.c_str();
     }
 
     void FSUIPCClient::setLastError(Error error, const char * errorMessage) {
@@ -6,10 +6,16 @@
 #include <memory>
 #include <string>
 #include "fsuipc_definition.h"
+#include "fsuipc_transport.h"
+#include "fsuipc_batch_log.h"
+#include "fsuipc_stats.h"
 
 namespace FSUIPC {
     class FSUIPCClient {
     public:
+        // Bytes of one batch, including the terminating DWORD
+        static constexpr size_t MAX_SIZE = 0x7F00;
+
         FSUIPCClient();
 
         ~FSUIPCClient();
@@ -38,6 +44,10 @@ namespace FSUIPC {
 
         bool process();
 
+        bool processImage(BYTE *image, size_t size);
+
+        void discardRequests() noexcept;
+
         void clearError();
 
         Error getLastError();
@@ -46,14 +56,28 @@ namespace FSUIPC {
 
         ApiVersion getApiVersion() const;
 
+        bool setTransport(std::unique_ptr<Transport> transport);
+
+        void setRecorder(std::unique_ptr<BatchRecorder> batchRecorder);
+
+        BatchRecorder *getRecorder() const noexcept;
+
+        const Statistics &getStatistics() const noexcept;
+
+        void resetStatistics() noexcept;
+
     private:
         std::unordered_map<DWORD, void *> dataMap;
         std::unique_ptr<State> state;
         int dataId = 0;
         Error lastError = Error::OK;
-        const char *lastErrorMessage{};
-        static constexpr size_t MAX_SIZE = 0x7F00;
+        std::string lastErrorMessage;
         ApiVersion apiVersion = API_UNKNOWN;
+        std::unique_ptr<Transport> transport;
+        std::unique_ptr<BatchRecorder> recorder;
+        Statistics statistics;
+        std::chrono::steady_clock::time_point batchStart;
+        uint32_t pendingRequests = 0;
 
         void setLastError(Error error, const char *errorMessage);
 
@@ -61,10 +85,14 @@ namespace FSUIPC {
 
         bool verifyVersion(Simulator requested);
 
-        bool sendRequests();
+        bool initializeTransport();
+
+        bool sendRequests(size_t size);
 
         bool processResponses();
 
+        void zeroResponses(size_t size) noexcept;
+
         bool checkApiVersion();
     };
 }
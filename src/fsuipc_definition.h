@@ -4,6 +4,7 @@
 
 #include "windows.h"
 #include <cstdint>
+#include <memory>
 #include <minwindef.h>
 
 namespace FSUIPC {
@@ -55,7 +56,11 @@ namespace FSUIPC {
         SEND_MESSAGE = 12,
         BAD_DATA = 13,
         NOT_RUNNING = 14,
-        BUFFER_FULL = 15
+        BUFFER_FULL = 15,
+        LOG_FILE = 16,
+        REPLAY_END = 17,
+        REPLAY_MISMATCH = 18,
+        NOT_PUBLISHED = 19
     };
 
     struct VersionInfo {
@@ -89,6 +94,7 @@ namespace FSUIPC {
         BYTE *pView = nullptr;
         BYTE *pNext = nullptr;
         VersionInfo version{};
+        std::unique_ptr<BYTE[]> buffer;
 
         ~State() noexcept {
             reset();
@@ -121,6 +127,12 @@ namespace FSUIPC {
         COM2StandbyVer1() : ReadDataWORD(0x311C) {}
     };
 
+    // COM frequency in Hz from the four decimal digits of a BCD frequency offset, which leaves
+    // out the leading 1 and the last 2.5 kHz of 25 kHz spaced channels
+    inline uint32_t bcdFrequency(uint32_t digits) noexcept {
+        return static_cast<uint32_t>(digits * 10 + 100000 + (digits % 5) * 2.5) * 1000;
+    }
+
     struct ReadDataBYTE {
         uint32_t offset;
         size_t size;
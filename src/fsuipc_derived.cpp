@@ -0,0 +1,280 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#include "fsuipc_derived.h"
+#include "fsuipc_client.h"
+#include <cmath>
+#include <cstring>
+
+namespace FSUIPC {
+    constexpr double EARTH_RADIUS_NM = 3440.065;
+    constexpr double DEGREE_TO_RADIAN = 3.14159265358979323846 / 180.0;
+    constexpr BYTE COM1_TRANSMIT = 0x80;
+    constexpr BYTE COM2_TRANSMIT = 0x40;
+
+    static double comFrequency(const double *inputs, size_t) {
+        return static_cast<double>(bcdFrequency(static_cast<uint32_t>(inputs[0])));
+    }
+
+    static double activeRadio(const double *inputs, size_t) {
+        auto flags = static_cast<uint32_t>(inputs[0]);
+        if (flags & COM1_TRANSMIT) {
+            return 1;
+        }
+        if (flags & COM2_TRANSMIT) {
+            return 2;
+        }
+        return 0;
+    }
+
+    static double distanceNm(const double *inputs, size_t) {
+        double lat1 = inputs[0] * DEGREE_TO_RADIAN;
+        double lon1 = inputs[1] * DEGREE_TO_RADIAN;
+        double lat2 = inputs[2] * DEGREE_TO_RADIAN;
+        double lon2 = inputs[3] * DEGREE_TO_RADIAN;
+        double sinLat = std::sin((lat2 - lat1) / 2);
+        double sinLon = std::sin((lon2 - lon1) / 2);
+        double a = sinLat * sinLat + std::cos(lat1) * std::cos(lat2) * sinLon * sinLon;
+        return 2 * EARTH_RADIUS_NM * std::asin(std::sqrt(std::fmin(1.0, a)));
+    }
+
+    int DerivedGraph::addValue(const std::vector<DerivedInput> &valueInputs, Function function) {
+        if (valueInputs.empty() || !function) {
+            lastErrorMessage = "A derived value needs at least one input and a function";
+            return -1;
+        }
+
+        for (const auto &input: valueInputs) {
+            if (input.type > static_cast<uint32_t>(InputType::BCD)) {
+                lastErrorMessage = "Unknown derived input type";
+                return -1;
+            }
+            bool floating = input.type == static_cast<uint32_t>(InputType::FLOAT);
+            if (floating ? input.size != 4 && input.size != 8 :
+                input.size != 1 && input.size != 2 && input.size != 4 && input.size != 8) {
+                lastErrorMessage = "Unsupported derived input size";
+                return -1;
+            }
+        }
+
+        if (getBatchSize() + getAddedBatchSize(valueInputs) + sizeof(DWORD) > FSUIPCClient::MAX_SIZE) {
+            lastErrorMessage = "Derived inputs no longer fit in one batch";
+            return -1;
+        }
+
+        Node node;
+        node.function = std::move(function);
+        node.dirty = true;
+        for (const auto &input: valueInputs) {
+            size_t index = findOrAddInput(input);
+            inputs[index].dependents.push_back(nodes.size());
+            node.inputs.push_back(index);
+        }
+        if (node.inputs.size() > arguments.size()) {
+            arguments.resize(node.inputs.size());
+        }
+        nodes.push_back(std::move(node));
+        lastErrorMessage = "";
+        return static_cast<int>(nodes.size() - 1);
+    }
+
+    int DerivedGraph::addValue(DerivedKind kind, const std::vector<DerivedInput> &valueInputs,
+                               double scale, double bias) {
+        switch (kind) {
+            case DerivedKind::LINEAR:
+                if (valueInputs.size() != 1) {
+                    break;
+                }
+                return addValue(valueInputs, [scale, bias](const double *values, size_t) {
+                    return values[0] * scale + bias;
+                });
+            case DerivedKind::BCD_FREQUENCY:
+                if (valueInputs.size() != 1) {
+                    break;
+                }
+                if (valueInputs[0].type != static_cast<uint32_t>(InputType::BCD)) {
+                    lastErrorMessage = "BCD frequency input must be of BCD type";
+                    return -1;
+                }
+                return addValue(valueInputs, comFrequency);
+            case DerivedKind::ACTIVE_RADIO:
+                if (valueInputs.size() != 1) {
+                    break;
+                }
+                return addValue(valueInputs, activeRadio);
+            case DerivedKind::DISTANCE_NM:
+                if (valueInputs.size() != 4) {
+                    break;
+                }
+                return addValue(valueInputs, distanceNm);
+            default:
+                lastErrorMessage = "Unknown derived value kind";
+                return -1;
+        }
+        lastErrorMessage = "Wrong number of inputs for derived value kind";
+        return -1;
+    }
+
+    void DerivedGraph::clear() noexcept {
+        inputs.clear();
+        nodes.clear();
+        pending = false;
+    }
+
+    size_t DerivedGraph::size() const noexcept {
+        return nodes.size();
+    }
+
+    size_t DerivedGraph::getBatchSize() const noexcept {
+        size_t size = 0;
+        for (const auto &input: inputs) {
+            size += sizeof(ReadHeader) + input.size;
+        }
+        return size;
+    }
+
+    size_t DerivedGraph::getAddedBatchSize(const std::vector<DerivedInput> &valueInputs) const noexcept {
+        size_t size = 0;
+        for (size_t i = 0; i < valueInputs.size(); i++) {
+            if (findInput(valueInputs[i]) != inputs.size()) {
+                continue;
+            }
+            bool repeated = false;
+            for (size_t j = 0; j < i && !repeated; j++) {
+                const DerivedInput &earlier = valueInputs[j];
+                repeated = earlier.offset == valueInputs[i].offset && earlier.size == valueInputs[i].size &&
+                           earlier.type == valueInputs[i].type && earlier.scale == valueInputs[i].scale;
+            }
+            if (!repeated) {
+                size += sizeof(ReadHeader) + valueInputs[i].size;
+            }
+        }
+        return size;
+    }
+
+    bool DerivedGraph::queue(FSUIPCClient &client) {
+        pending = false;
+        for (auto &input: inputs) {
+            input.slot = 0;
+            if (!client.read(input.offset, input.size, &input.slot)) {
+                lastErrorMessage = "Failed to queue derived input read";
+                return false;
+            }
+        }
+        pending = !inputs.empty();
+        return true;
+    }
+
+    void DerivedGraph::commit() {
+        if (!pending) {
+            return;
+        }
+        pending = false;
+
+        for (auto &input: inputs) {
+            if (input.valid && input.slot == input.raw) {
+                continue;
+            }
+            input.raw = input.slot;
+            input.value = decode(input);
+            input.valid = true;
+            for (size_t dependent: input.dependents) {
+                nodes[dependent].dirty = true;
+            }
+        }
+    }
+
+    double DerivedGraph::getValue(size_t id) {
+        if (id >= nodes.size()) {
+            return 0;
+        }
+        Node &node = nodes[id];
+        if (node.dirty) {
+            evaluate(node);
+        }
+        return node.value;
+    }
+
+    uint64_t DerivedGraph::getVersion(size_t id) const noexcept {
+        return id < nodes.size() ? nodes[id].version : 0;
+    }
+
+    const char *DerivedGraph::getLastErrorMessage() const noexcept {
+        return lastErrorMessage;
+    }
+
+    size_t DerivedGraph::findInput(const DerivedInput &input) const noexcept {
+        for (size_t i = 0; i < inputs.size(); i++) {
+            const Input &existing = inputs[i];
+            if (existing.offset == input.offset && existing.size == input.size &&
+                existing.type == static_cast<InputType>(input.type) && existing.scale == input.scale) {
+                return i;
+            }
+        }
+        return inputs.size();
+    }
+
+    size_t DerivedGraph::findOrAddInput(const DerivedInput &input) {
+        size_t index = findInput(input);
+        if (index != inputs.size()) {
+            return index;
+        }
+        Input &created = inputs.emplace_back();
+        created.offset = input.offset;
+        created.size = input.size;
+        created.type = static_cast<InputType>(input.type);
+        created.scale = input.scale;
+        return inputs.size() - 1;
+    }
+
+    void DerivedGraph::evaluate(Node &node) {
+        node.dirty = false;
+        for (size_t i = 0; i < node.inputs.size(); i++) {
+            const Input &input = inputs[node.inputs[i]];
+            if (!input.valid) {
+                return;
+            }
+            arguments[i] = input.value;
+        }
+
+        double value = node.function(arguments.data(), node.inputs.size());
+        if (node.version == 0 || value != node.value) {
+            node.value = value;
+            node.version++;
+        }
+    }
+
+    double DerivedGraph::decode(const Input &input) noexcept {
+        uint64_t raw = input.raw;
+        double value;
+        switch (input.type) {
+            case InputType::SIGNED: {
+                int shift = static_cast<int>(64 - input.size * 8);
+                value = static_cast<double>(static_cast<int64_t>(raw << shift) >> shift);
+                break;
+            }
+            case InputType::FLOAT:
+                if (input.size == sizeof(float)) {
+                    float single;
+                    memcpy(&single, &raw, sizeof(single));
+                    value = single;
+                } else {
+                    double full;
+                    memcpy(&full, &raw, sizeof(full));
+                    value = full;
+                }
+                break;
+            case InputType::BCD: {
+                uint64_t decimal = 0;
+                for (int nibble = static_cast<int>(input.size * 2) - 1; nibble >= 0; nibble--) {
+                    decimal = decimal * 10 + ((raw >> (nibble * 4)) & 0xF);
+                }
+                value = static_cast<double>(decimal);
+                break;
+            }
+            default:
+                value = static_cast<double>(raw);
+                break;
+        }
+        return value * input.scale;
+    }
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <vector>
+#include "fsuipc_definition.h"
+
+namespace FSUIPC {
+    class FSUIPCClient;
+
+    enum class InputType {
+        UNSIGNED = 0,
+        SIGNED = 1,
+        FLOAT = 2,
+        BCD = 3
+    };
+
+    enum class DerivedKind {
+        // scale * input0 + bias
+        LINEAR = 0,
+        // COM frequency in Hz from a 4 digit BCD offset read as InputType::BCD, as ReadFrequencyInfo reports it
+        BCD_FREQUENCY = 1,
+        // 1 when COM1 transmits, 2 when COM2 transmits, 0 otherwise, from the radio switch flags
+        ACTIVE_RADIO = 2,
+        // Great circle distance in nautical miles between (input0, input1) and (input2, input3) in degrees
+        DISTANCE_NM = 3
+    };
+
+    // One raw offset feeding a derived value. The decoded number is multiplied by scale.
+    struct DerivedInput {
+        uint32_t offset;
+        uint32_t size;
+        uint32_t type;
+        double scale;
+    };
+
+    // Values computed from raw offsets that are only recomputed when one of
+    // their inputs changed in the last committed batch, and only when read.
+    class DerivedGraph {
+    public:
+        using Function = std::function<double(const double *inputs, size_t count)>;
+
+        int addValue(const std::vector<DerivedInput> &valueInputs, Function function);
+
+        int addValue(DerivedKind kind, const std::vector<DerivedInput> &valueInputs, double scale, double bias);
+
+        void clear() noexcept;
+
+        size_t size() const noexcept;
+
+        size_t getBatchSize() const noexcept;
+
+        size_t getAddedBatchSize(const std::vector<DerivedInput> &valueInputs) const noexcept;
+
+        bool queue(FSUIPCClient &client);
+
+        void commit();
+
+        double getValue(size_t id);
+
+        uint64_t getVersion(size_t id) const noexcept;
+
+        const char *getLastErrorMessage() const noexcept;
+
+    private:
+        struct Input {
+            uint32_t offset;
+            size_t size;
+            InputType type;
+            double scale;
+            uint64_t slot = 0;
+            uint64_t raw = 0;
+            double value = 0;
+            bool valid = false;
+            std::vector<size_t> dependents;
+        };
+
+        struct Node {
+            std::vector<size_t> inputs;
+            Function function;
+            double value = 0;
+            uint64_t version = 0;
+            bool dirty = false;
+        };
+
+        std::deque<Input> inputs;
+        std::vector<Node> nodes;
+        std::vector<double> arguments;
+        bool pending = false;
+        const char *lastErrorMessage = "";
+
+        size_t findInput(const DerivedInput &input) const noexcept;
+
+        size_t findOrAddInput(const DerivedInput &input);
+
+        void evaluate(Node &node);
+
+        static double decode(const Input &input) noexcept;
+    };
+}
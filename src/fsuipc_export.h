@@ -3,6 +3,8 @@
 #pragma once
 
 #include "fsuipc_definition.h"
+#include "fsuipc_stats.h"
+#include "fsuipc_derived.h"
 
 #define DLL_EXPORT extern "C" __declspec(dllexport)
 
@@ -12,10 +14,76 @@ typedef struct ReturnValue {
     uint8_t frequencyFlag{};
     uint32_t frequency[4]{};
     uint32_t status{FSUIPC::SimConnectionStatus::NO_CONNECTION};
+    // Holds errMessage when it is copied from a client error that may change after the call returns
+    char errBuffer[256]{};
 } ReturnValue;
 
+typedef struct TelemetrySeries {
+    bool requestStatus{false};
+    const char *errMessage{"No error found"};
+    uint32_t count{};
+    int64_t *timestamp{};
+    int64_t *value{};
+} TelemetrySeries;
+
+typedef struct DerivedValues {
+    bool requestStatus{false};
+    const char *errMessage{"No error found"};
+    uint32_t count{};
+    double *value{};
+    uint64_t *version{};
+} DerivedValues;
+
+typedef struct StatisticsValue {
+    bool requestStatus{false};
+    const char *errMessage{"No error found"};
+    FSUIPC::HistogramSummary buildTime{};
+    FSUIPC::HistogramSummary roundTripTime{};
+    FSUIPC::HistogramSummary parseTime{};
+    FSUIPC::HistogramSummary batchBytes{};
+    FSUIPC::HistogramSummary batchRequests{};
+    uint64_t batches{};
+    uint64_t failedBatches{};
+    uint64_t retries{};
+    uint64_t timeouts{};
+    uint64_t sendErrors{};
+    uint64_t badData{};
+    uint64_t bytes{};
+    uint64_t requests{};
+    uint64_t reconnects{};
+} StatisticsValue;
+
 DLL_EXPORT ReturnValue *OpenFSUIPCClient();
 DLL_EXPORT ReturnValue *ReadFrequencyInfo();
 DLL_EXPORT ReturnValue *CloseFSUIPCClient();
 DLL_EXPORT ReturnValue *GetConnectionState();
+DLL_EXPORT ReturnValue *OpenFSUIPCReplay(const char *path, double speed);
+DLL_EXPORT ReturnValue *StartBatchRecording(const char *path);
+DLL_EXPORT ReturnValue *StopBatchRecording();
+DLL_EXPORT ReturnValue *OpenFSUIPCSubscriber(const char *name);
+DLL_EXPORT ReturnValue *StartPublisher(const char *name);
+DLL_EXPORT ReturnValue *StopPublisher();
+DLL_EXPORT ReturnValue *AddPublishedOffset(uint32_t offset, uint32_t size);
+DLL_EXPORT ReturnValue *OpenFSUIPCRemote(const char *host, uint16_t port, bool compress, uint32_t pipelineDepth,
+                                         uint32_t maxAgeMs);
+DLL_EXPORT ReturnValue *StartGateway(const char *address, uint16_t port);
+DLL_EXPORT ReturnValue *StopGateway();
+DLL_EXPORT ReturnValue *AddTelemetryChannel(uint32_t offset, uint32_t size);
+DLL_EXPORT ReturnValue *RemoveTelemetryChannel(uint32_t offset);
+DLL_EXPORT ReturnValue *SetTelemetryRetention(uint64_t maxBytes);
+DLL_EXPORT ReturnValue *StartTelemetryStream(const char *path);
+DLL_EXPORT ReturnValue *StopTelemetryStream();
+DLL_EXPORT ReturnValue *ExportTelemetry(const char *path);
+DLL_EXPORT TelemetrySeries *QueryTelemetry(uint32_t offset, int64_t from, int64_t to);
+DLL_EXPORT ReturnValue *AddDerivedValue(uint32_t kind, const FSUIPC::DerivedInput *inputs, uint32_t inputCount,
+                                        double scale, double bias);
+DLL_EXPORT ReturnValue *ClearDerivedValues();
+DLL_EXPORT DerivedValues *ReadDerivedValues();
+DLL_EXPORT StatisticsValue *GetStatistics();
+DLL_EXPORT ReturnValue *ResetStatistics();
+DLL_EXPORT ReturnValue *DumpTrace(const char *path);
+DLL_EXPORT ReturnValue *ClearTrace();
 DLL_EXPORT void FreeMemory(ReturnValue *);
+DLL_EXPORT void FreeTelemetrySeries(TelemetrySeries *);
+DLL_EXPORT void FreeDerivedValues(DerivedValues *);
+DLL_EXPORT void FreeStatistics(StatisticsValue *);
@@ -0,0 +1,591 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include "fsuipc_network.h"
+#include "fsuipc_client.h"
+#include "fsuipc_trace.h"
+#include <cstring>
+
+namespace FSUIPC {
+    constexpr size_t FRAME_MAX_PAYLOAD = FRAME_MAX_IMAGE * 2 + 64;
+
+    static void writeVarint(std::vector<BYTE> &data, uint32_t value) {
+        while (value >= 0x80) {
+            data.push_back(static_cast<BYTE>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<BYTE>(value));
+    }
+
+    static bool readVarint(const BYTE *&cursor, const BYTE *end, uint32_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 35 && cursor < end; shift += 7) {
+            BYTE byte = *cursor++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Delta payload: pairs of (unchanged run length, changed run length) varints,
+    // each followed by the changed bytes.
+    static void encodeDelta(const BYTE *current, const BYTE *previous, size_t size, std::vector<BYTE> &out) {
+        out.clear();
+        size_t position = 0;
+        while (position < size) {
+            size_t unchanged = 0;
+            while (position + unchanged < size && current[position + unchanged] == previous[position + unchanged]) {
+                unchanged++;
+            }
+            position += unchanged;
+
+            size_t changed = 0;
+            while (position + changed < size && current[position + changed] != previous[position + changed]) {
+                changed++;
+            }
+
+            writeVarint(out, static_cast<uint32_t>(unchanged));
+            writeVarint(out, static_cast<uint32_t>(changed));
+            out.insert(out.end(), current + position, current + position + changed);
+            position += changed;
+        }
+    }
+
+    static bool decodeDelta(const std::vector<BYTE> &payload, std::vector<BYTE> &image) {
+        const BYTE *cursor = payload.data();
+        const BYTE *end = cursor + payload.size();
+        size_t position = 0;
+        while (cursor < end) {
+            uint32_t unchanged, changed;
+            if (!readVarint(cursor, end, unchanged) || !readVarint(cursor, end, changed)) {
+                return false;
+            }
+            if (unchanged > image.size() - position) {
+                return false;
+            }
+            position += unchanged;
+            if (changed > image.size() - position || static_cast<size_t>(end - cursor) < changed) {
+                return false;
+            }
+            memcpy(image.data() + position, cursor, changed);
+            cursor += changed;
+            position += changed;
+        }
+        return true;
+    }
+
+    static bool sendAll(SocketHandle socket, const void *data, size_t size) {
+        auto *cursor = static_cast<const char *>(data);
+        while (size > 0) {
+            int sent = ::send(static_cast<SOCKET>(socket), cursor, static_cast<int>(size), 0);
+            if (sent <= 0) {
+                return false;
+            }
+            cursor += sent;
+            size -= sent;
+        }
+        return true;
+    }
+
+    static bool receiveAll(SocketHandle socket, void *data, size_t size) {
+        auto *cursor = static_cast<char *>(data);
+        while (size > 0) {
+            int received = ::recv(static_cast<SOCKET>(socket), cursor, static_cast<int>(size), 0);
+            if (received <= 0) {
+                return false;
+            }
+            cursor += received;
+            size -= received;
+        }
+        return true;
+    }
+
+    static void setNoDelay(SocketHandle socket) {
+        BOOL noDelay = TRUE;
+        setsockopt(static_cast<SOCKET>(socket), IPPROTO_TCP, TCP_NODELAY,
+                   reinterpret_cast<const char *>(&noDelay), sizeof(noDelay));
+    }
+
+    static void setTimeouts(SocketHandle socket) {
+        DWORD timeout = SOCKET_TIMEOUT_MS;
+        setsockopt(static_cast<SOCKET>(socket), SOL_SOCKET, SO_RCVTIMEO,
+                   reinterpret_cast<const char *>(&timeout), sizeof(timeout));
+        setsockopt(static_cast<SOCKET>(socket), SOL_SOCKET, SO_SNDTIMEO,
+                   reinterpret_cast<const char *>(&timeout), sizeof(timeout));
+    }
+
+    static bool startWinsock() {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+
+    bool FrameChannel::send(SocketHandle socket, FrameType type, const BYTE *image, size_t size,
+                            bool delta, uint32_t flags) {
+        FrameHeader header{FRAME_MAGIC, static_cast<uint32_t>(type), flags,
+                           static_cast<uint32_t>(Error::OK), static_cast<uint32_t>(size), 0};
+        const BYTE *body = image;
+        header.payloadSize = header.imageSize;
+
+        if (delta && previous.size() == size) {
+            encodeDelta(image, previous.data(), size, payload);
+            if (payload.size() < size) {
+                header.flags |= FRAME_DELTA;
+                header.payloadSize = static_cast<uint32_t>(payload.size());
+                body = payload.data();
+            }
+        }
+        previous.assign(image, image + size);
+
+        return sendAll(socket, &header, sizeof(header)) && sendAll(socket, body, header.payloadSize);
+    }
+
+    bool FrameChannel::sendError(SocketHandle socket, Error error, const char *message) {
+        size_t length = message ? strlen(message) : 0;
+        FrameHeader header{FRAME_MAGIC, static_cast<uint32_t>(FrameType::RESPONSE), 0,
+                           static_cast<uint32_t>(error), 0, static_cast<uint32_t>(length)};
+        return sendAll(socket, &header, sizeof(header)) && sendAll(socket, message, length);
+    }
+
+    bool FrameChannel::receive(SocketHandle socket, FrameHeader &header, std::vector<BYTE> &image) {
+        if (!receiveAll(socket, &header, sizeof(header)) ||
+            header.magic != FRAME_MAGIC ||
+            header.imageSize > FRAME_MAX_IMAGE ||
+            header.payloadSize > FRAME_MAX_PAYLOAD) {
+            return false;
+        }
+
+        payload.resize(header.payloadSize);
+        if (!receiveAll(socket, payload.data(), payload.size())) {
+            return false;
+        }
+
+        if (header.status != static_cast<uint32_t>(Error::OK)) {
+            image.assign(payload.begin(), payload.end());
+            image.push_back(0);
+            return true;
+        }
+
+        if (header.flags & FRAME_DELTA) {
+            if (previous.size() != header.imageSize) {
+                return false;
+            }
+            image = previous;
+            if (!decodeDelta(payload, image)) {
+                return false;
+            }
+        } else {
+            if (header.payloadSize != header.imageSize) {
+                return false;
+            }
+            image.assign(payload.begin(), payload.end());
+        }
+        previous = image;
+        return true;
+    }
+
+    void FrameChannel::reset() noexcept {
+        previous.clear();
+    }
+
+    NetworkGateway::NetworkGateway(FSUIPCClient &client, std::mutex &clientMutex) :
+            client(client), clientMutex(clientMutex) {}
+
+    NetworkGateway::~NetworkGateway() {
+        stop();
+    }
+
+    bool NetworkGateway::start(const std::string &address, uint16_t port) {
+        stop();
+
+        if (!startWinsock()) {
+            lastErrorMessage = "Failed to initialize Winsock";
+            return false;
+        }
+        winsockStarted = true;
+
+        sockaddr_in endpoint{};
+        endpoint.sin_family = AF_INET;
+        endpoint.sin_port = htons(port);
+        if (inet_pton(AF_INET, address.c_str(), &endpoint.sin_addr) != 1) {
+            lastErrorMessage = "Invalid gateway address";
+            stop();
+            return false;
+        }
+
+        SOCKET socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (socket == INVALID_SOCKET) {
+            lastErrorMessage = "Failed to create gateway socket";
+            stop();
+            return false;
+        }
+        listener = static_cast<SocketHandle>(socket);
+
+        if (bind(socket, reinterpret_cast<const sockaddr *>(&endpoint), sizeof(endpoint)) == SOCKET_ERROR ||
+            listen(socket, SOMAXCONN) == SOCKET_ERROR) {
+            lastErrorMessage = "Failed to listen on gateway port";
+            stop();
+            return false;
+        }
+
+        running = true;
+        acceptor = std::thread(&NetworkGateway::acceptLoop, this);
+        lastErrorMessage = "";
+        return true;
+    }
+
+    void NetworkGateway::stop() noexcept {
+        running = false;
+
+        if (listener != INVALID_SOCKET_HANDLE) {
+            shutdown(static_cast<SOCKET>(listener), SD_BOTH);
+            closesocket(static_cast<SOCKET>(listener));
+            listener = INVALID_SOCKET_HANDLE;
+        }
+        if (acceptor.joinable()) {
+            acceptor.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            for (auto &connection: connections) {
+                if (!connection.finished) {
+                    shutdown(static_cast<SOCKET>(connection.socket), SD_BOTH);
+                }
+            }
+        }
+        for (auto &connection: connections) {
+            if (connection.worker.joinable()) {
+                connection.worker.join();
+            }
+        }
+        connections.clear();
+
+        if (winsockStarted) {
+            WSACleanup();
+            winsockStarted = false;
+        }
+    }
+
+    bool NetworkGateway::isRunning() const noexcept {
+        return running;
+    }
+
+    const char *NetworkGateway::getLastErrorMessage() const noexcept {
+        return lastErrorMessage;
+    }
+
+    void NetworkGateway::acceptLoop() {
+        while (running) {
+            SOCKET socket = accept(static_cast<SOCKET>(listener), nullptr, nullptr);
+            if (socket == INVALID_SOCKET) {
+                continue;
+            }
+            setNoDelay(static_cast<SocketHandle>(socket));
+
+            reapConnections();
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            if (!running) {
+                closesocket(socket);
+                break;
+            }
+            Connection &connection = connections.emplace_back();
+            connection.socket = static_cast<SocketHandle>(socket);
+            connection.worker = std::thread(&NetworkGateway::serve, this, std::ref(connection));
+        }
+    }
+
+    void NetworkGateway::serve(Connection &connection) {
+        FrameChannel incoming;
+        FrameChannel outgoing;
+        FrameHeader header{};
+        std::vector<BYTE> image;
+        std::string message;
+
+        while (running && incoming.receive(connection.socket, header, image)) {
+            if (header.type != static_cast<uint32_t>(FrameType::REQUEST)) {
+                break;
+            }
+
+            bool processed;
+            Error error;
+            {
+                FSUIPC_TRACE_SCOPE("gatewayRequest");
+                std::lock_guard<std::mutex> lock(clientMutex);
+                processed = client.processImage(image.data(), image.size());
+                error = client.getLastError();
+                message = client.getLastErrorMessage();
+            }
+
+            bool sent = processed ?
+                        outgoing.send(connection.socket, FrameType::RESPONSE, image.data(), image.size(),
+                                      header.flags & FRAME_ACCEPT_DELTA, 0) :
+                        outgoing.sendError(connection.socket, error, message.c_str());
+            if (!sent) {
+                break;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        closesocket(static_cast<SOCKET>(connection.socket));
+        connection.finished = true;
+    }
+
+    void NetworkGateway::reapConnections() {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        for (auto it = connections.begin(); it != connections.end();) {
+            if (it->finished) {
+                it->worker.join();
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    NetworkTransport::NetworkTransport(std::string host, uint16_t port, bool compress, uint32_t pipelineDepth,
+                                       uint32_t maxAgeMs) :
+            host(std::move(host)), port(port), compress(compress), pipelineDepth(pipelineDepth), maxAge(maxAgeMs) {}
+
+    NetworkTransport::~NetworkTransport() {
+        disconnect();
+    }
+
+    bool NetworkTransport::connect() {
+        disconnect();
+
+        if (!startWinsock()) {
+            setLastError(Error::NO_SIMULATOR, "Failed to initialize Winsock");
+            return false;
+        }
+        winsockStarted = true;
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+        addrinfo *addresses = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+            setLastError(Error::NO_SIMULATOR, "Failed to resolve gateway host");
+            disconnect();
+            return false;
+        }
+
+        for (addrinfo *address = addresses; address; address = address->ai_next) {
+            SOCKET candidate = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (candidate == INVALID_SOCKET) {
+                continue;
+            }
+            if (::connect(candidate, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+                socket = static_cast<SocketHandle>(candidate);
+                break;
+            }
+            closesocket(candidate);
+        }
+        freeaddrinfo(addresses);
+
+        if (socket == INVALID_SOCKET_HANDLE) {
+            setLastError(Error::NO_SIMULATOR, "Failed to connect to gateway");
+            disconnect();
+            return false;
+        }
+
+        setNoDelay(socket);
+        setTimeouts(socket);
+        outgoing.reset();
+        incoming.reset();
+        inFlight.clear();
+        speculate = true;
+        clearError();
+        return true;
+    }
+
+    void NetworkTransport::disconnect() noexcept {
+        if (socket != INVALID_SOCKET_HANDLE) {
+            closesocket(static_cast<SOCKET>(socket));
+            socket = INVALID_SOCKET_HANDLE;
+        }
+        inFlight.clear();
+
+        if (winsockStarted) {
+            WSACleanup();
+            winsockStarted = false;
+        }
+    }
+
+    bool NetworkTransport::transact(BYTE *buffer, size_t size) {
+        if (socket == INVALID_SOCKET_HANDLE) {
+            setLastError(Error::NOT_OPEN, "Not connected to gateway");
+            return false;
+        }
+
+        bool fresh = !inFlight.empty() && std::chrono::steady_clock::now() - inFlight.front().sentAt <= maxAge;
+        if (fresh && inFlight.front().image.size() == size && sameShape(inFlight.front().image.data(), buffer, size)) {
+            inFlight.pop_front();
+            if (!receiveResponse()) {
+                return false;
+            }
+            if (response.size() != size) {
+                setLastError(Error::BAD_DATA, "Gateway response size does not match the request");
+                return false;
+            }
+            mergeReads(buffer, response.data(), size);
+        } else {
+            if (!inFlight.empty() && !fresh) {
+                speculate = false;
+            }
+            if (!drain() || !sendRequest(buffer, size) || !receiveResponse()) {
+                return false;
+            }
+            if (response.size() != size) {
+                setLastError(Error::BAD_DATA, "Gateway response size does not match the request");
+                return false;
+            }
+            memcpy(buffer, response.data(), size);
+        }
+
+        if (speculate && pipelineDepth > 0 && !hasWrites(buffer, size)) {
+            while (inFlight.size() < pipelineDepth) {
+                if (!sendRequest(buffer, size)) {
+                    return false;
+                }
+                inFlight.push_back({std::vector<BYTE>(buffer, buffer + size), std::chrono::steady_clock::now()});
+            }
+        }
+
+        clearError();
+        return true;
+    }
+
+    void NetworkTransport::connectionLost() {
+        // A timed out socket is left in an undefined state, so it is dropped as well
+        bool timedOut = WSAGetLastError() == WSAETIMEDOUT;
+        disconnect();
+        if (timedOut) {
+            setLastError(Error::TIMEOUT, "Gateway did not answer in time");
+        } else {
+            setLastError(Error::SEND_MESSAGE, "Connection to gateway lost");
+        }
+    }
+
+    bool NetworkTransport::sendRequest(const BYTE *image, size_t size) {
+        WSASetLastError(0);
+        if (!outgoing.send(socket, FrameType::REQUEST, image, size, compress, compress ? FRAME_ACCEPT_DELTA : 0)) {
+            connectionLost();
+            return false;
+        }
+        return true;
+    }
+
+    bool NetworkTransport::receiveResponse() {
+        FrameHeader header{};
+        WSASetLastError(0);
+        if (!incoming.receive(socket, header, response)) {
+            connectionLost();
+            return false;
+        }
+
+        if (header.type != static_cast<uint32_t>(FrameType::RESPONSE)) {
+            disconnect();
+            setLastError(Error::BAD_DATA, "Unexpected frame from gateway");
+            return false;
+        }
+
+        if (header.status != static_cast<uint32_t>(Error::OK)) {
+            setLastError(static_cast<Error>(header.status), reinterpret_cast<const char *>(response.data()));
+            return false;
+        }
+        return true;
+    }
+
+    bool NetworkTransport::drain() {
+        while (!inFlight.empty()) {
+            inFlight.pop_front();
+            if (!receiveResponse() && socket == INVALID_SOCKET_HANDLE) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool NetworkTransport::sameShape(const BYTE *left, const BYTE *right, size_t size) noexcept {
+        size_t position = 0;
+        while (position + sizeof(DWORD) <= size) {
+            DWORD id, otherId;
+            memcpy(&id, left + position, sizeof(DWORD));
+            memcpy(&otherId, right + position, sizeof(DWORD));
+            if (id != otherId) {
+                return false;
+            }
+            if (id == 0) {
+                return true;
+            }
+
+            if (id == static_cast<DWORD>(MessageType::READ) && position + sizeof(ReadHeader) <= size) {
+                ReadHeader header{}, other{};
+                memcpy(&header, left + position, sizeof(ReadHeader));
+                memcpy(&other, right + position, sizeof(ReadHeader));
+                if (header.offset != other.offset || header.size != other.size) {
+                    return false;
+                }
+                position += sizeof(ReadHeader) + header.size;
+            } else if (id == static_cast<DWORD>(MessageType::WRITE) && position + sizeof(WriteHeader) <= size) {
+                WriteHeader header{}, other{};
+                memcpy(&header, left + position, sizeof(WriteHeader));
+                memcpy(&other, right + position, sizeof(WriteHeader));
+                position += sizeof(WriteHeader);
+                if (header.offset != other.offset || header.size != other.size ||
+                    position + header.size > size ||
+                    memcmp(left + position, right + position, header.size) != 0) {
+                    return false;
+                }
+                position += header.size;
+            } else {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool NetworkTransport::hasWrites(const BYTE *image, size_t size) noexcept {
+        size_t position = 0;
+        while (position + sizeof(DWORD) <= size) {
+            DWORD id;
+            memcpy(&id, image + position, sizeof(DWORD));
+            if (id == static_cast<DWORD>(MessageType::READ) && position + sizeof(ReadHeader) <= size) {
+                ReadHeader header{};
+                memcpy(&header, image + position, sizeof(ReadHeader));
+                position += sizeof(ReadHeader) + header.size;
+            } else {
+                return id != 0;
+            }
+        }
+        return false;
+    }
+
+    void NetworkTransport::mergeReads(BYTE *destination, const BYTE *source, size_t size) noexcept {
+        size_t position = 0;
+        while (position + sizeof(DWORD) <= size) {
+            DWORD id;
+            memcpy(&id, destination + position, sizeof(DWORD));
+            if (id == static_cast<DWORD>(MessageType::READ) && position + sizeof(ReadHeader) <= size) {
+                ReadHeader header{};
+                memcpy(&header, destination + position, sizeof(ReadHeader));
+                position += sizeof(ReadHeader);
+                if (position + header.size > size) {
+                    return;
+                }
+                memcpy(destination + position, source + position, header.size);
+                position += header.size;
+            } else if (id == static_cast<DWORD>(MessageType::WRITE) && position + sizeof(WriteHeader) <= size) {
+                WriteHeader header{};
+                memcpy(&header, destination + position, sizeof(WriteHeader));
+                position += sizeof(WriteHeader) + header.size;
+            } else {
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fsuipc_transport.h"
+
+namespace FSUIPC {
+    class FSUIPCClient;
+
+    // Wire format: every batch travels as one frame, a FrameHeader followed by
+    // payloadSize bytes. With FRAME_DELTA the payload is the request or response
+    // image encoded against the previous image sent in the same direction,
+    // otherwise it is the image itself. Error responses carry the message text.
+    constexpr uint32_t FRAME_MAGIC = 0x46495046;
+    constexpr uint32_t FRAME_MAX_IMAGE = 0x8000;
+    constexpr uint32_t FRAME_DELTA = 0x1;
+    constexpr uint32_t FRAME_ACCEPT_DELTA = 0x2;
+    constexpr uint32_t PIPELINE_MAX_AGE_MS = 50;
+    constexpr uint32_t SOCKET_TIMEOUT_MS = 2000;
+
+    enum class FrameType {
+        REQUEST = 1,
+        RESPONSE = 2
+    };
+
+    struct FrameHeader {
+        uint32_t magic;
+        uint32_t type;
+        uint32_t flags;
+        uint32_t status;
+        uint32_t imageSize;
+        uint32_t payloadSize;
+    };
+
+    using SocketHandle = uintptr_t;
+    constexpr SocketHandle INVALID_SOCKET_HANDLE = ~static_cast<SocketHandle>(0);
+
+    // One direction of a connection: remembers the last image so the next one
+    // can be sent as a delta.
+    class FrameChannel {
+    public:
+        bool send(SocketHandle socket, FrameType type, const BYTE *image, size_t size, bool delta, uint32_t flags);
+
+        bool sendError(SocketHandle socket, Error error, const char *message);
+
+        bool receive(SocketHandle socket, FrameHeader &header, std::vector<BYTE> &image);
+
+        void reset() noexcept;
+
+    private:
+        std::vector<BYTE> previous;
+        std::vector<BYTE> payload;
+    };
+
+    // Serves FSUIPCClient::processImage() over TCP. Each connection gets its own
+    // thread; requests are answered in order, so clients may pipeline them.
+    // There is no authentication: any peer that reaches the port can read and
+    // write every offset, so bind to loopback unless the network is trusted.
+    class NetworkGateway {
+    public:
+        NetworkGateway(FSUIPCClient &client, std::mutex &clientMutex);
+
+        ~NetworkGateway();
+
+        NetworkGateway(const NetworkGateway &) = delete;
+
+        NetworkGateway &operator=(const NetworkGateway &) = delete;
+
+        bool start(const std::string &address, uint16_t port);
+
+        void stop() noexcept;
+
+        bool isRunning() const noexcept;
+
+        const char *getLastErrorMessage() const noexcept;
+
+    private:
+        struct Connection {
+            SocketHandle socket;
+            std::thread worker;
+            std::atomic<bool> finished{false};
+        };
+
+        FSUIPCClient &client;
+        std::mutex &clientMutex;
+        SocketHandle listener = INVALID_SOCKET_HANDLE;
+        std::thread acceptor;
+        std::mutex connectionsMutex;
+        std::list<Connection> connections;
+        std::atomic<bool> running{false};
+        bool winsockStarted = false;
+        const char *lastErrorMessage = "";
+
+        void acceptLoop();
+
+        void serve(Connection &connection);
+
+        void reapConnections();
+    };
+
+    // Runs FSUIPCClient against a remote NetworkGateway.
+    // With pipelineDepth > 0 a read-only batch is sent again right after its
+    // response arrives, up to pipelineDepth times, so a polling loop that
+    // repeats the same batch finds its response already in flight. Such a
+    // response was sampled when its request went out; once that is more than
+    // maxAgeMs ago it is discarded and the batch is sent afresh. The caller
+    // evidently polls slower than that, so no more requests are sent ahead
+    // until the next connect().
+    class NetworkTransport : public Transport {
+    public:
+        NetworkTransport(std::string host, uint16_t port, bool compress = true, uint32_t pipelineDepth = 0,
+                         uint32_t maxAgeMs = PIPELINE_MAX_AGE_MS);
+
+        ~NetworkTransport() override;
+
+        bool connect() override;
+
+        void disconnect() noexcept override;
+
+        bool transact(BYTE *buffer, size_t size) override;
+
+    private:
+        struct InFlight {
+            std::vector<BYTE> image;
+            std::chrono::steady_clock::time_point sentAt;
+        };
+
+        std::string host;
+        uint16_t port;
+        bool compress;
+        uint32_t pipelineDepth;
+        std::chrono::milliseconds maxAge;
+        SocketHandle socket = INVALID_SOCKET_HANDLE;
+        bool winsockStarted = false;
+        FrameChannel outgoing;
+        FrameChannel incoming;
+        std::deque<InFlight> inFlight;
+        std::vector<BYTE> response;
+        bool speculate = true;
+
+        void connectionLost();
+
+        bool sendRequest(const BYTE *image, size_t size);
+
+        bool receiveResponse();
+
+        bool drain();
+
+        static bool sameShape(const BYTE *left, const BYTE *right, size_t size) noexcept;
+
+        static bool hasWrites(const BYTE *image, size_t size) noexcept;
+
+        static void mergeReads(BYTE *destination, const BYTE *source, size_t size) noexcept;
+    };
+}
@@ -0,0 +1,316 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#include "fsuipc_shared.h"
+#include "fsuipc_client.h"
+#include <chrono>
+#include <cstring>
+#include <new>
+
+namespace FSUIPC {
+    constexpr char SHARED_NAME_PREFIX[] = "FSUIPC-LIB:";
+    constexpr int SNAPSHOT_SPIN_LIMIT = 1000;
+    constexpr auto SNAPSHOT_TIMEOUT = std::chrono::milliseconds(1000);
+
+    static int64_t currentTime() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    SnapshotPublisher::~SnapshotPublisher() {
+        close();
+    }
+
+    bool SnapshotPublisher::create(const std::string &name) {
+        close();
+
+        std::string mappingName = std::string(SHARED_NAME_PREFIX).append(name);
+        hMap = CreateFileMapping(
+                INVALID_HANDLE_VALUE,
+                nullptr,
+                PAGE_READWRITE,
+                0, sizeof(SharedRegion),
+                mappingName.c_str());
+
+        if (!hMap || GetLastError() == ERROR_ALREADY_EXISTS) {
+            lastErrorMessage = "Failed to create shared memory, another publisher may already be running";
+            close();
+            return false;
+        }
+
+        region = static_cast<SharedRegion *>(MapViewOfFile(hMap, FILE_MAP_WRITE, 0, 0, sizeof(SharedRegion)));
+        if (!region) {
+            lastErrorMessage = "Failed to map view of shared memory";
+            close();
+            return false;
+        }
+
+        new(&region->sequence) std::atomic<uint64_t>(0);
+        region->version = SHARED_REGION_VERSION;
+        std::atomic_thread_fence(std::memory_order_release);
+        region->magic = SHARED_REGION_MAGIC;
+
+        lastErrorMessage = "";
+        return true;
+    }
+
+    void SnapshotPublisher::close() noexcept {
+        if (region) {
+            publish(false);
+            UnmapViewOfFile(region);
+            region = nullptr;
+        }
+
+        if (hMap) {
+            CloseHandle(hMap);
+            hMap = nullptr;
+        }
+        pending = false;
+    }
+
+    bool SnapshotPublisher::isOpen() const noexcept {
+        return region != nullptr;
+    }
+
+    bool SnapshotPublisher::addOffset(uint32_t offset, size_t size) {
+        if (hasOffset(offset, size)) {
+            return true;
+        }
+
+        if (size == 0 || entries.size() >= SHARED_MAX_ENTRIES || staging.size() + size > SHARED_MAX_DATA) {
+            lastErrorMessage = "Shared memory has no room for this offset";
+            return false;
+        }
+
+        if (getBatchSize() + sizeof(ReadHeader) + size + sizeof(DWORD) > FSUIPCClient::MAX_SIZE) {
+            lastErrorMessage = "Published offsets no longer fit in one batch";
+            return false;
+        }
+
+        // Reads queued by queue() point into staging, so it must never reallocate
+        staging.reserve(SHARED_MAX_DATA);
+        entries.push_back({offset, static_cast<uint32_t>(size), static_cast<uint32_t>(staging.size()), 0});
+        staging.resize(staging.size() + size);
+        pending = false;
+        lastErrorMessage = "";
+        return true;
+    }
+
+    bool SnapshotPublisher::hasOffset(uint32_t offset, size_t size) const noexcept {
+        for (const auto &entry: entries) {
+            if (entry.offset == offset && entry.size == size) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t SnapshotPublisher::getBatchSize() const noexcept {
+        return entries.size() * sizeof(ReadHeader) + staging.size();
+    }
+
+    bool SnapshotPublisher::queue(FSUIPCClient &client) {
+        pending = false;
+        if (!region) {
+            return true;
+        }
+        for (const auto &entry: entries) {
+            if (!client.read(entry.offset, entry.size, staging.data() + entry.position)) {
+                lastErrorMessage = "Failed to queue published offset read";
+                return false;
+            }
+        }
+        pending = !entries.empty();
+        return true;
+    }
+
+    void SnapshotPublisher::commit() {
+        if (!pending) {
+            return;
+        }
+        pending = false;
+        publish(true);
+    }
+
+    void SnapshotPublisher::markDisconnected() {
+        pending = false;
+        if (region) {
+            publish(false);
+        }
+    }
+
+    const char *SnapshotPublisher::getLastErrorMessage() const noexcept {
+        return lastErrorMessage;
+    }
+
+    void SnapshotPublisher::publish(bool connected) {
+        uint64_t sequence = region->sequence.load(std::memory_order_relaxed);
+        region->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        region->publishTime = currentTime();
+        region->connected = connected ? 1 : 0;
+        region->entryCount = static_cast<uint32_t>(entries.size());
+        region->dataSize = static_cast<uint32_t>(staging.size());
+        if (!entries.empty()) {
+            memcpy(region->entries, entries.data(), entries.size() * sizeof(SharedEntry));
+            memcpy(region->data, staging.data(), staging.size());
+        }
+
+        region->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    SnapshotTransport::SnapshotTransport(std::string name, uint32_t staleAfterMs) :
+            name(std::move(name)), staleAfter(static_cast<int64_t>(staleAfterMs) * 1000) {}
+
+    SnapshotTransport::~SnapshotTransport() {
+        disconnect();
+    }
+
+    bool SnapshotTransport::connect() {
+        disconnect();
+
+        std::string mappingName = std::string(SHARED_NAME_PREFIX).append(name);
+        hMap = OpenFileMapping(FILE_MAP_READ, FALSE, mappingName.c_str());
+        if (!hMap) {
+            setLastError(Error::NO_SIMULATOR, "No publisher found for this shared memory name");
+            return false;
+        }
+
+        region = static_cast<const SharedRegion *>(MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, sizeof(SharedRegion)));
+        if (!region) {
+            setLastError(Error::CREATE_VIEW, "Failed to map view of shared memory");
+            disconnect();
+            return false;
+        }
+
+        if (region->magic != SHARED_REGION_MAGIC || region->version != SHARED_REGION_VERSION) {
+            setLastError(Error::VERSION_MISMATCH, "Shared memory layout does not match this library");
+            disconnect();
+            return false;
+        }
+
+        entries.reserve(SHARED_MAX_ENTRIES);
+        data.reserve(SHARED_MAX_DATA);
+        clearError();
+        return true;
+    }
+
+    void SnapshotTransport::disconnect() noexcept {
+        if (region) {
+            UnmapViewOfFile(region);
+            region = nullptr;
+        }
+
+        if (hMap) {
+            CloseHandle(hMap);
+            hMap = nullptr;
+        }
+    }
+
+    bool SnapshotTransport::transact(BYTE *buffer, size_t size) {
+        if (!takeSnapshot()) {
+            return false;
+        }
+
+        if (!connected) {
+            setLastError(Error::NOT_RUNNING, "Publisher is not connected to the simulator");
+            return false;
+        }
+
+        if (currentTime() - publishTime > staleAfter) {
+            setLastError(Error::NOT_RUNNING, "Publisher has stopped publishing");
+            return false;
+        }
+
+        size_t position = 0;
+        while (position + sizeof(DWORD) <= size) {
+            DWORD id;
+            memcpy(&id, buffer + position, sizeof(DWORD));
+            if (id == 0) {
+                break;
+            }
+
+            if (id == static_cast<DWORD>(MessageType::READ) && position + sizeof(ReadHeader) <= size) {
+                ReadHeader header{};
+                memcpy(&header, buffer + position, sizeof(ReadHeader));
+                position += sizeof(ReadHeader);
+                if (position + header.size > size) {
+                    setLastError(Error::BAD_DATA, "Malformed request image");
+                    return false;
+                }
+                const BYTE *source = find(header.offset, header.size);
+                if (!source) {
+                    setLastError(Error::NOT_PUBLISHED, "Offset is not published by the shared memory owner");
+                    return false;
+                }
+                memcpy(buffer + position, source, header.size);
+                position += header.size;
+            } else if (id == static_cast<DWORD>(MessageType::WRITE) && position + sizeof(WriteHeader) <= size) {
+                WriteHeader header{};
+                memcpy(&header, buffer + position, sizeof(WriteHeader));
+                position += sizeof(WriteHeader) + header.size;
+            } else {
+                setLastError(Error::BAD_DATA, "Malformed request image");
+                return false;
+            }
+        }
+
+        clearError();
+        return true;
+    }
+
+    bool SnapshotTransport::takeSnapshot() {
+        std::chrono::steady_clock::time_point deadline;
+        for (int spin = 0;; spin++) {
+            uint64_t before = region->sequence.load(std::memory_order_acquire);
+            if (before == 0) {
+                setLastError(Error::NO_DATA_FOUND, "Publisher has not published any data yet");
+                return false;
+            }
+
+            if (!(before & 1)) {
+                uint32_t entryCount = region->entryCount;
+                uint32_t dataSize = region->dataSize;
+                if (entryCount > SHARED_MAX_ENTRIES) {
+                    entryCount = 0;
+                }
+                if (dataSize > SHARED_MAX_DATA) {
+                    dataSize = 0;
+                }
+                connected = region->connected;
+                publishTime = region->publishTime;
+                entries.assign(region->entries, region->entries + entryCount);
+                data.assign(region->data, region->data + dataSize);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (region->sequence.load(std::memory_order_relaxed) == before) {
+                    return true;
+                }
+            }
+
+            if (spin < SNAPSHOT_SPIN_LIMIT) {
+                YieldProcessor();
+                continue;
+            }
+            // A publisher that died mid-write leaves the sequence odd forever
+            auto now = std::chrono::steady_clock::now();
+            if (spin == SNAPSHOT_SPIN_LIMIT) {
+                deadline = now + SNAPSHOT_TIMEOUT;
+            } else if (now >= deadline) {
+                setLastError(Error::TIMEOUT, "Publisher did not finish a snapshot in time");
+                return false;
+            }
+            Sleep(1);
+        }
+    }
+
+    const BYTE *SnapshotTransport::find(uint32_t offset, size_t size) const noexcept {
+        for (const auto &entry: entries) {
+            if (offset >= entry.offset && offset + size <= static_cast<size_t>(entry.offset) + entry.size &&
+                entry.position + entry.size <= data.size()) {
+                return data.data() + entry.position + (offset - entry.offset);
+            }
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "fsuipc_transport.h"
+
+namespace FSUIPC {
+    class FSUIPCClient;
+
+    constexpr uint32_t SHARED_REGION_MAGIC = 0x53435046;
+    constexpr uint32_t SHARED_REGION_VERSION = 1;
+    constexpr size_t SHARED_MAX_ENTRIES = 256;
+    constexpr size_t SHARED_MAX_DATA = 0x7F00;
+    constexpr uint32_t SHARED_STALE_AFTER_MS = 5000;
+
+    struct SharedEntry {
+        uint32_t offset;
+        uint32_t size;
+        uint32_t position;
+        uint32_t reserved;
+    };
+
+    // Named shared memory written by one publisher and read by any number of
+    // subscribers. Everything after sequence is guarded by it as a seqlock:
+    // odd while the publisher writes, even once a snapshot is complete.
+    struct SharedRegion {
+        uint32_t magic;
+        uint32_t version;
+        std::atomic<uint64_t> sequence;
+        // steady_clock microseconds; on Windows it counts from boot for every process
+        int64_t publishTime;
+        uint32_t connected;
+        uint32_t entryCount;
+        uint32_t dataSize;
+        uint32_t reserved;
+        SharedEntry entries[SHARED_MAX_ENTRIES];
+        BYTE data[SHARED_MAX_DATA];
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Seqlock needs a lock-free 64 bit atomic");
+
+    // Owner side: adds the registered offsets to the owner's batches and
+    // publishes the results as one versioned snapshot per batch.
+    class SnapshotPublisher {
+    public:
+        SnapshotPublisher() = default;
+
+        ~SnapshotPublisher();
+
+        SnapshotPublisher(const SnapshotPublisher &) = delete;
+
+        SnapshotPublisher &operator=(const SnapshotPublisher &) = delete;
+
+        bool create(const std::string &name);
+
+        void close() noexcept;
+
+        bool isOpen() const noexcept;
+
+        bool addOffset(uint32_t offset, size_t size);
+
+        bool hasOffset(uint32_t offset, size_t size) const noexcept;
+
+        size_t getBatchSize() const noexcept;
+
+        bool queue(FSUIPCClient &client);
+
+        void commit();
+
+        void markDisconnected();
+
+        const char *getLastErrorMessage() const noexcept;
+
+    private:
+        HANDLE hMap = nullptr;
+        SharedRegion *region = nullptr;
+        std::vector<SharedEntry> entries;
+        std::vector<BYTE> staging;
+        bool pending = false;
+        const char *lastErrorMessage = "";
+
+        void publish(bool connected);
+    };
+
+    // Subscriber side: serves the reads of a batch from one consistent
+    // snapshot without any IPC to the simulator. Subscribers are read-only,
+    // so write requests are accepted but not forwarded. A snapshot older than
+    // staleAfterMs counts as a dead publisher.
+    class SnapshotTransport : public Transport {
+    public:
+        explicit SnapshotTransport(std::string name, uint32_t staleAfterMs = SHARED_STALE_AFTER_MS);
+
+        ~SnapshotTransport() override;
+
+        bool connect() override;
+
+        void disconnect() noexcept override;
+
+        bool transact(BYTE *buffer, size_t size) override;
+
+    private:
+        std::string name;
+        int64_t staleAfter;
+        HANDLE hMap = nullptr;
+        const SharedRegion *region = nullptr;
+        std::vector<SharedEntry> entries;
+        std::vector<BYTE> data;
+        uint32_t connected = 0;
+        int64_t publishTime = 0;
+
+        bool takeSnapshot();
+
+        const BYTE *find(uint32_t offset, size_t size) const noexcept;
+    };
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#include "fsuipc_stats.h"
+#include <bit>
+#include <cmath>
+
+namespace FSUIPC {
+    void Histogram::record(uint64_t value) noexcept {
+        counts[bucketIndex(value)]++;
+        count++;
+        sum += value;
+        if (value < min) {
+            min = value;
+        }
+        if (value > max) {
+            max = value;
+        }
+    }
+
+    void Histogram::reset() noexcept {
+        counts.fill(0);
+        count = 0;
+        min = UINT64_MAX;
+        max = 0;
+        sum = 0;
+    }
+
+    uint64_t Histogram::percentile(double percent) const noexcept {
+        if (count == 0) {
+            return 0;
+        }
+
+        auto target = static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(count)));
+        if (target == 0) {
+            target = 1;
+        }
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= target) {
+                uint64_t upper = bucketUpperBound(i);
+                return upper > max ? max : upper;
+            }
+        }
+        return max;
+    }
+
+    HistogramSummary Histogram::summarize() const noexcept {
+        HistogramSummary summary{};
+        summary.count = count;
+        if (count == 0) {
+            return summary;
+        }
+        summary.min = min;
+        summary.max = max;
+        summary.mean = sum / count;
+        summary.p50 = percentile(50.0);
+        summary.p90 = percentile(90.0);
+        summary.p99 = percentile(99.0);
+        summary.p999 = percentile(99.9);
+        return summary;
+    }
+
+    size_t Histogram::bucketIndex(uint64_t value) noexcept {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        int magnitude = std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+        size_t subBucket = static_cast<size_t>(value >> magnitude) & (SUB_BUCKETS - 1);
+        return SUB_BUCKETS + static_cast<size_t>(magnitude) * SUB_BUCKETS + subBucket;
+    }
+
+    uint64_t Histogram::bucketUpperBound(size_t index) noexcept {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        size_t magnitude = (index - SUB_BUCKETS) / SUB_BUCKETS;
+        uint64_t subBucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+        uint64_t lower = (SUB_BUCKETS + subBucket) << magnitude;
+        return lower + ((uint64_t{1} << magnitude) - 1);
+    }
+
+    void Statistics::recordFailure(Error error) noexcept {
+        failedBatches++;
+        switch (error) {
+            case Error::TIMEOUT:
+                timeouts++;
+                break;
+            case Error::SEND_MESSAGE:
+                sendErrors++;
+                break;
+            case Error::BAD_DATA:
+                badData++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    void Statistics::reset() noexcept {
+        buildTime.reset();
+        roundTripTime.reset();
+        parseTime.reset();
+        batchBytes.reset();
+        batchRequests.reset();
+        batches = failedBatches = retries = timeouts = sendErrors = badData = 0;
+        bytes = requests = 0;
+        reconnects = 0;
+    }
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include "fsuipc_definition.h"
+
+namespace FSUIPC {
+    struct HistogramSummary {
+        uint64_t count;
+        uint64_t min;
+        uint64_t max;
+        uint64_t mean;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+    };
+
+    // Log-linear histogram in the HDR style: every power of two is split into
+    // 16 sub-buckets, so any recorded value is reported within 6.25%.
+    // record() is a handful of integer operations and never allocates.
+    class Histogram {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 4;
+        static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+        static constexpr size_t BUCKETS = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+        void record(uint64_t value) noexcept;
+
+        void reset() noexcept;
+
+        uint64_t percentile(double percent) const noexcept;
+
+        HistogramSummary summarize() const noexcept;
+
+    private:
+        std::array<uint64_t, BUCKETS> counts{};
+        uint64_t count = 0;
+        uint64_t min = UINT64_MAX;
+        uint64_t max = 0;
+        uint64_t sum = 0;
+
+        static size_t bucketIndex(uint64_t value) noexcept;
+
+        static uint64_t bucketUpperBound(size_t index) noexcept;
+    };
+
+    // Always-on instrumentation of FSUIPCClient. Times are in nanoseconds.
+    struct Statistics {
+        Histogram buildTime;
+        Histogram roundTripTime;
+        Histogram parseTime;
+        Histogram batchBytes;
+        Histogram batchRequests;
+        uint64_t batches = 0;
+        uint64_t failedBatches = 0;
+        uint64_t retries = 0;
+        uint64_t timeouts = 0;
+        uint64_t sendErrors = 0;
+        uint64_t badData = 0;
+        uint64_t bytes = 0;
+        uint64_t requests = 0;
+        uint64_t connections = 0;
+        uint64_t reconnects = 0;
+
+        void recordFailure(Error error) noexcept;
+
+        void reset() noexcept;
+
+        static uint64_t elapsed(std::chrono::steady_clock::time_point since) noexcept {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - since).count());
+        }
+    };
+}
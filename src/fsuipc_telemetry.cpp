@@ -0,0 +1,336 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#include "fsuipc_telemetry.h"
+#include "fsuipc_client.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace FSUIPC {
+    // Worst case for one sample: two 10-byte varints
+    constexpr size_t MAX_SAMPLE_BYTES = 20;
+
+    static uint64_t zigZagEncode(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static int64_t zigZagDecode(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    static void writeVarint(std::vector<BYTE> &data, uint64_t value) {
+        while (value >= 0x80) {
+            data.push_back(static_cast<BYTE>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<BYTE>(value));
+    }
+
+    static uint64_t readVarint(const BYTE *&cursor, const BYTE *end) {
+        uint64_t value = 0;
+        int shift = 0;
+        while (cursor < end && shift < 64) {
+            BYTE byte = *cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+            shift += 7;
+        }
+        return value;
+    }
+
+    TelemetryRecorder::~TelemetryRecorder() {
+        closeStream();
+    }
+
+    bool TelemetryRecorder::addChannel(uint32_t offset, size_t size) {
+        if (size != 1 && size != 2 && size != 4 && size != 8) {
+            lastErrorMessage = "Telemetry channel size must be 1, 2, 4 or 8 bytes";
+            return false;
+        }
+
+        for (const auto &existing: channels) {
+            if (existing.offset == offset) {
+                lastErrorMessage = "Telemetry channel already exists";
+                return false;
+            }
+        }
+
+        if (getBatchSize() + sizeof(ReadHeader) + size + sizeof(DWORD) > FSUIPCClient::MAX_SIZE) {
+            lastErrorMessage = "Telemetry channels no longer fit in one batch";
+            return false;
+        }
+
+        Channel &channel = channels.emplace_back();
+        channel.offset = offset;
+        channel.size = size;
+        lastErrorMessage.clear();
+        return true;
+    }
+
+    bool TelemetryRecorder::removeChannel(uint32_t offset) {
+        auto it = std::find_if(channels.begin(), channels.end(),
+                               [offset](const Channel &channel) { return channel.offset == offset; });
+        if (it == channels.end()) {
+            lastErrorMessage = "Telemetry channel not found";
+            return false;
+        }
+
+        if (!it->chunks.empty()) {
+            seal(*it, it->chunks.back());
+        }
+        for (const auto &chunk: it->chunks) {
+            memoryUsage -= sizeof(Chunk) + chunk.data.capacity();
+        }
+        channels.erase(it);
+        pending = false;
+        lastErrorMessage.clear();
+        return true;
+    }
+
+    bool TelemetryRecorder::empty() const noexcept {
+        return channels.empty();
+    }
+
+    void TelemetryRecorder::setRetention(size_t maxBytes) noexcept {
+        retention = maxBytes;
+        enforceRetention();
+    }
+
+    size_t TelemetryRecorder::getMemoryUsage() const noexcept {
+        return memoryUsage;
+    }
+
+    size_t TelemetryRecorder::getBatchSize() const noexcept {
+        size_t size = 0;
+        for (const auto &channel: channels) {
+            size += sizeof(ReadHeader) + channel.size;
+        }
+        return size;
+    }
+
+    bool TelemetryRecorder::queue(FSUIPCClient &client) {
+        pending = false;
+        for (auto &channel: channels) {
+            channel.slot = 0;
+            if (!client.read(channel.offset, channel.size, &channel.slot)) {
+                lastErrorMessage = "Failed to queue telemetry read";
+                return false;
+            }
+        }
+        pending = !channels.empty();
+        return true;
+    }
+
+    void TelemetryRecorder::commit() {
+        commit(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    void TelemetryRecorder::commit(int64_t timestamp) {
+        if (!pending) {
+            return;
+        }
+        pending = false;
+
+        for (auto &channel: channels) {
+            append(channel, timestamp);
+        }
+        enforceRetention();
+    }
+
+    void TelemetryRecorder::append(Channel &channel, int64_t timestamp) {
+        auto value = static_cast<int64_t>(channel.slot);
+
+        if (channel.chunks.empty() || channel.chunks.back().sealed ||
+            channel.chunks.back().data.size() + MAX_SAMPLE_BYTES > CHUNK_SIZE) {
+            if (!channel.chunks.empty()) {
+                seal(channel, channel.chunks.back());
+            }
+            Chunk &chunk = channel.chunks.emplace_back();
+            chunk.data.reserve(CHUNK_SIZE);
+            chunk.firstTime = chunk.lastTime = timestamp;
+            chunk.firstValue = chunk.lastValue = value;
+            chunk.count = 1;
+            memoryUsage += sizeof(Chunk) + chunk.data.capacity();
+            return;
+        }
+
+        Chunk &chunk = channel.chunks.back();
+        int64_t delta = timestamp - chunk.lastTime;
+        writeVarint(chunk.data, zigZagEncode(delta - chunk.lastDelta));
+        writeVarint(chunk.data, zigZagEncode(value - chunk.lastValue));
+        chunk.lastDelta = delta;
+        chunk.lastTime = timestamp;
+        chunk.lastValue = value;
+        chunk.count++;
+    }
+
+    void TelemetryRecorder::seal(Channel &channel, Chunk &chunk) {
+        chunk.sealed = true;
+        if (hStream != INVALID_HANDLE_VALUE && !chunk.streamed) {
+            chunk.streamed = writeChunk(hStream, channel, chunk);
+        }
+    }
+
+    void TelemetryRecorder::enforceRetention() {
+        while (memoryUsage > retention) {
+            Channel *oldest = nullptr;
+            for (auto &channel: channels) {
+                if (channel.chunks.size() < 2) {
+                    continue;
+                }
+                if (!oldest || channel.chunks.front().firstTime < oldest->chunks.front().firstTime) {
+                    oldest = &channel;
+                }
+            }
+            if (!oldest) {
+                return;
+            }
+            memoryUsage -= sizeof(Chunk) + oldest->chunks.front().data.capacity();
+            oldest->chunks.pop_front();
+        }
+    }
+
+    bool TelemetryRecorder::hasChannel(uint32_t offset) const noexcept {
+        return std::any_of(channels.begin(), channels.end(),
+                           [offset](const Channel &channel) { return channel.offset == offset; });
+    }
+
+    std::vector<TelemetrySample> TelemetryRecorder::query(uint32_t offset, int64_t from, int64_t to) const {
+        std::vector<TelemetrySample> samples;
+
+        auto it = std::find_if(channels.begin(), channels.end(),
+                               [offset](const Channel &channel) { return channel.offset == offset; });
+        if (it == channels.end()) {
+            return samples;
+        }
+
+        for (const auto &chunk: it->chunks) {
+            if (chunk.lastTime < from || chunk.firstTime > to) {
+                continue;
+            }
+
+            int64_t timestamp = chunk.firstTime;
+            int64_t value = chunk.firstValue;
+            int64_t delta = 0;
+            const BYTE *cursor = chunk.data.data();
+            const BYTE *end = cursor + chunk.data.size();
+
+            for (uint32_t i = 0; i < chunk.count; i++) {
+                if (i > 0) {
+                    delta += zigZagDecode(readVarint(cursor, end));
+                    timestamp += delta;
+                    value += zigZagDecode(readVarint(cursor, end));
+                }
+                if (timestamp > to) {
+                    break;
+                }
+                if (timestamp >= from) {
+                    samples.push_back({timestamp, value});
+                }
+            }
+        }
+        return samples;
+    }
+
+    bool TelemetryRecorder::openStream(const std::string &path) {
+        closeStream();
+
+        hStream = createExportFile(path);
+        if (hStream == INVALID_HANDLE_VALUE) {
+            lastErrorMessage = "Failed to create telemetry stream file";
+            return false;
+        }
+        lastErrorMessage.clear();
+        return true;
+    }
+
+    void TelemetryRecorder::closeStream() noexcept {
+        if (hStream == INVALID_HANDLE_VALUE) {
+            return;
+        }
+
+        // Flush open chunks so the file covers everything recorded so far;
+        // the next sample of each channel starts a fresh chunk.
+        for (auto &channel: channels) {
+            if (!channel.chunks.empty()) {
+                seal(channel, channel.chunks.back());
+            }
+        }
+
+        FlushFileBuffers(hStream);
+        CloseHandle(hStream);
+        hStream = INVALID_HANDLE_VALUE;
+    }
+
+    bool TelemetryRecorder::exportTo(const std::string &path) {
+        HANDLE hFile = createExportFile(path);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            lastErrorMessage = "Failed to create telemetry export file";
+            return false;
+        }
+
+        bool result = true;
+        for (const auto &channel: channels) {
+            for (const auto &chunk: channel.chunks) {
+                if (!writeChunk(hFile, channel, chunk)) {
+                    result = false;
+                    break;
+                }
+            }
+            if (!result) {
+                break;
+            }
+        }
+
+        CloseHandle(hFile);
+        if (result) {
+            lastErrorMessage.clear();
+        }
+        return result;
+    }
+
+    const char *TelemetryRecorder::getLastErrorMessage() const noexcept {
+        return lastErrorMessage.c_str();
+    }
+
+    bool TelemetryRecorder::writeChunk(HANDLE hFile, const Channel &channel, const Chunk &chunk) {
+        TelemetryChunkHeader header{};
+        header.offset = channel.offset;
+        header.size = static_cast<uint32_t>(channel.size);
+        header.count = chunk.count;
+        header.byteLength = static_cast<uint32_t>(chunk.data.size());
+        header.firstTime = chunk.firstTime;
+        header.firstValue = chunk.firstValue;
+
+        DWORD written = 0;
+        if (!WriteFile(hFile, &header, sizeof(header), &written, nullptr) || written != sizeof(header) ||
+            !WriteFile(hFile, chunk.data.data(), header.byteLength, &written, nullptr) ||
+            written != header.byteLength) {
+            lastErrorMessage = "Failed to write telemetry chunk";
+            return false;
+        }
+        return true;
+    }
+
+    HANDLE TelemetryRecorder::createExportFile(const std::string &path) {
+        HANDLE hFile = CreateFile(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                  CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            return hFile;
+        }
+
+        TelemetryFileHeader header{};
+        memcpy(header.magic, TELEMETRY_FILE_MAGIC, sizeof(header.magic));
+        header.version = TELEMETRY_FILE_VERSION;
+
+        DWORD written = 0;
+        if (!WriteFile(hFile, &header, sizeof(header), &written, nullptr) || written != sizeof(header)) {
+            CloseHandle(hFile);
+            return INVALID_HANDLE_VALUE;
+        }
+        return hFile;
+    }
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "fsuipc_definition.h"
+
+namespace FSUIPC {
+    class FSUIPCClient;
+
+    // Export file layout: TelemetryFileHeader, then TelemetryChunkHeader + data
+    // for every chunk. Chunk data holds the samples after the first one as pairs of
+    // zig-zag varints: time delta-of-delta and value delta.
+    constexpr char TELEMETRY_FILE_MAGIC[8] = {'F', 'S', 'U', 'I', 'P', 'C', 'T', 'S'};
+    constexpr uint32_t TELEMETRY_FILE_VERSION = 1;
+
+    struct TelemetryFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+    };
+
+    struct TelemetryChunkHeader {
+        uint32_t offset;
+        uint32_t size;
+        uint32_t count;
+        uint32_t byteLength;
+        int64_t firstTime;
+        int64_t firstValue;
+    };
+
+    struct TelemetrySample {
+        int64_t timestamp;
+        int64_t value;
+    };
+
+    // Keeps the history of selected offsets as per-offset columnar chunks.
+    // Values are the raw offset contents zero-extended to 64 bit, timestamps are
+    // microseconds since the Unix epoch.
+    class TelemetryRecorder {
+    public:
+        static constexpr size_t CHUNK_SIZE = 4096;
+        static constexpr size_t DEFAULT_RETENTION = 64 * 1024 * 1024;
+
+        TelemetryRecorder() = default;
+
+        ~TelemetryRecorder();
+
+        TelemetryRecorder(const TelemetryRecorder &) = delete;
+
+        TelemetryRecorder &operator=(const TelemetryRecorder &) = delete;
+
+        bool addChannel(uint32_t offset, size_t size);
+
+        bool removeChannel(uint32_t offset);
+
+        bool empty() const noexcept;
+
+        void setRetention(size_t maxBytes) noexcept;
+
+        size_t getMemoryUsage() const noexcept;
+
+        size_t getBatchSize() const noexcept;
+
+        bool queue(FSUIPCClient &client);
+
+        void commit();
+
+        void commit(int64_t timestamp);
+
+        bool hasChannel(uint32_t offset) const noexcept;
+
+        std::vector<TelemetrySample> query(uint32_t offset, int64_t from, int64_t to) const;
+
+        bool openStream(const std::string &path);
+
+        void closeStream() noexcept;
+
+        bool exportTo(const std::string &path);
+
+        const char *getLastErrorMessage() const noexcept;
+
+    private:
+        struct Chunk {
+            int64_t firstTime = 0;
+            int64_t lastTime = 0;
+            int64_t lastDelta = 0;
+            int64_t firstValue = 0;
+            int64_t lastValue = 0;
+            uint32_t count = 0;
+            bool sealed = false;
+            bool streamed = false;
+            std::vector<BYTE> data;
+        };
+
+        struct Channel {
+            uint32_t offset;
+            size_t size;
+            uint64_t slot = 0;
+            std::deque<Chunk> chunks;
+        };
+
+        std::deque<Channel> channels;
+        size_t retention = DEFAULT_RETENTION;
+        size_t memoryUsage = 0;
+        bool pending = false;
+        HANDLE hStream = INVALID_HANDLE_VALUE;
+        std::string lastErrorMessage;
+
+        void append(Channel &channel, int64_t timestamp);
+
+        void seal(Channel &channel, Chunk &chunk);
+
+        void enforceRetention();
+
+        bool writeChunk(HANDLE hFile, const Channel &channel, const Chunk &chunk);
+
+        static HANDLE createExportFile(const std::string &path);
+    };
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#include "fsuipc_trace.h"
+
+#ifdef FSUIPC_TRACE
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "windows.h"
+
+namespace FSUIPC::Trace {
+    struct Event {
+        const char *name;
+        uint64_t start;
+        uint64_t end;
+        char phase;
+    };
+
+    // Single producer ring owned by one thread. Each slot carries a sequence
+    // number (odd while being written) so dump() can read it from another
+    // thread without locking and drop the slots that were overwritten meanwhile.
+    struct Ring {
+        static constexpr size_t CAPACITY = 8192;
+
+        struct Slot {
+            std::atomic<uint64_t> sequence{0};
+            Event event{};
+        };
+
+        std::array<Slot, CAPACITY> slots;
+        std::atomic<uint64_t> head{0};
+        DWORD threadId = GetCurrentThreadId();
+
+        void push(const Event &event) noexcept {
+            uint64_t index = head.load(std::memory_order_relaxed);
+            Slot &slot = slots[index % CAPACITY];
+            slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.event = event;
+            slot.sequence.store(index * 2 + 2, std::memory_order_release);
+            head.store(index + 1, std::memory_order_release);
+        }
+
+        void collect(std::vector<Event> &events) const {
+            uint64_t end = head.load(std::memory_order_acquire);
+            uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+            for (uint64_t index = begin; index < end; index++) {
+                const Slot &slot = slots[index % CAPACITY];
+                uint64_t before = slot.sequence.load(std::memory_order_acquire);
+                Event event = slot.event;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+                if (before == after && before == index * 2 + 2) {
+                    events.push_back(event);
+                }
+            }
+        }
+    };
+
+    static std::mutex registryMutex;
+    static std::vector<std::shared_ptr<Ring>> registry;
+    static std::atomic<uint64_t> clearedAt{0};
+
+    static Ring &localRing() {
+        thread_local std::shared_ptr<Ring> ring = [] {
+            auto created = std::make_shared<Ring>();
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(created);
+            return created;
+        }();
+        return *ring;
+    }
+
+    uint64_t now() noexcept {
+        return toTime(std::chrono::steady_clock::now());
+    }
+
+    uint64_t toTime(std::chrono::steady_clock::time_point point) noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                point.time_since_epoch()).count());
+    }
+
+    void complete(const char *name, uint64_t start, uint64_t end) noexcept {
+        localRing().push({name, start, end, 'X'});
+    }
+
+    void instant(const char *name) noexcept {
+        uint64_t time = now();
+        localRing().push({name, time, time, 'i'});
+    }
+
+    bool dump(const std::string &path) {
+        std::ofstream output(path, std::ios::out | std::ios::trunc);
+        if (!output) {
+            return false;
+        }
+
+        std::vector<std::shared_ptr<Ring>> rings;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            rings = registry;
+        }
+
+        uint64_t since = clearedAt.load(std::memory_order_relaxed);
+        DWORD processId = GetCurrentProcessId();
+        bool first = true;
+        std::vector<Event> events;
+        std::vector<const Ring *> finished;
+        output << "{\"traceEvents\":[";
+        for (const auto &ring: rings) {
+            // Owned only by the registry and this copy: the thread has exited and
+            // the ring can be dropped once its last events are written out
+            if (ring.use_count() == 2) {
+                finished.push_back(ring.get());
+            }
+            events.clear();
+            ring->collect(events);
+            for (const auto &event: events) {
+                if (event.start < since) {
+                    continue;
+                }
+                output << (first ? "\n" : ",\n");
+                first = false;
+                output << "{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase
+                       << "\",\"ts\":" << event.start / 1000 << '.' << event.start % 1000 / 100;
+                if (event.phase == 'X') {
+                    output << ",\"dur\":" << (event.end - event.start) / 1000 << '.'
+                           << (event.end - event.start) % 1000 / 100;
+                } else {
+                    output << ",\"s\":\"t\"";
+                }
+                output << ",\"pid\":" << processId << ",\"tid\":" << ring->threadId << '}';
+            }
+        }
+        output << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        output.flush();
+        if (!output) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.erase(std::remove_if(registry.begin(), registry.end(),
+                                      [&finished](const std::shared_ptr<Ring> &ring) {
+                                          return std::find(finished.begin(), finished.end(), ring.get()) !=
+                                                 finished.end();
+                                      }),
+                       registry.end());
+        return true;
+    }
+
+    void clear() noexcept {
+        clearedAt.store(now(), std::memory_order_relaxed);
+
+        // Rings only referenced by the registry belong to threads that have exited
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.erase(std::remove_if(registry.begin(), registry.end(),
+                                      [](const std::shared_ptr<Ring> &ring) { return ring.use_count() == 1; }),
+                       registry.end());
+    }
+}
+
+#endif
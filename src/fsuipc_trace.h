@@ -0,0 +1,60 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#pragma once
+
+// Trace events of the IPC pipeline, enabled with the CMake option FSUIPC_TRACE.
+// Without it every macro below expands to nothing.
+
+#ifdef FSUIPC_TRACE
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace FSUIPC::Trace {
+    uint64_t now() noexcept;
+
+    uint64_t toTime(std::chrono::steady_clock::time_point point) noexcept;
+
+    void complete(const char *name, uint64_t start, uint64_t end) noexcept;
+
+    void instant(const char *name) noexcept;
+
+    // Writes the events of every thread as Chrome trace-event JSON
+    bool dump(const std::string &path);
+
+    // Hides the events recorded so far from the next dump()
+    void clear() noexcept;
+
+    class Scope {
+    public:
+        explicit Scope(const char *name) noexcept: name(name), start(now()) {}
+
+        ~Scope() {
+            complete(name, start, now());
+        }
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *name;
+        uint64_t start;
+    };
+}
+
+#define FSUIPC_TRACE_CONCAT_INNER(a, b) a##b
+#define FSUIPC_TRACE_CONCAT(a, b) FSUIPC_TRACE_CONCAT_INNER(a, b)
+#define FSUIPC_TRACE_SCOPE(name) ::FSUIPC::Trace::Scope FSUIPC_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define FSUIPC_TRACE_SINCE(name, start) \
+    ::FSUIPC::Trace::complete(name, ::FSUIPC::Trace::toTime(start), ::FSUIPC::Trace::now())
+#define FSUIPC_TRACE_INSTANT(name) ::FSUIPC::Trace::instant(name)
+
+#else
+
+#define FSUIPC_TRACE_SCOPE(name) ((void) 0)
+#define FSUIPC_TRACE_SINCE(name, start) ((void) 0)
+#define FSUIPC_TRACE_INSTANT(name) ((void) 0)
+
+#endif
@@ -0,0 +1,42 @@
+// Copyright (c) 2025 Half_nothing MIT License
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include "fsuipc_definition.h"
+
+namespace FSUIPC {
+    // Alternative to the window message IPC used by FSUIPCClient.
+    // transact() receives the request image built by read()/write() and
+    // must leave the response image in the same buffer, exactly like FSUIPC does.
+    class Transport {
+    public:
+        virtual ~Transport() = default;
+
+        virtual bool connect() = 0;
+
+        virtual void disconnect() noexcept = 0;
+
+        virtual bool transact(BYTE *buffer, size_t size) = 0;
+
+        Error getLastError() const noexcept { return lastError; }
+
+        const char *getLastErrorMessage() const noexcept { return lastErrorMessage.c_str(); }
+
+    protected:
+        void setLastError(Error error, std::string errorMessage) {
+            lastError = error;
+            lastErrorMessage = std::move(errorMessage);
+        }
+
+        void clearError() noexcept {
+            lastError = Error::OK;
+            lastErrorMessage.clear();
+        }
+
+    private:
+        Error lastError = Error::OK;
+        std::string lastErrorMessage;
+    };
+}